@@ -0,0 +1,109 @@
+#include <dlfcn.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "FFT.h"
+
+// Heap use of the analyzer's rendering (PathProducer in FFT.h), as the
+// AnalyzerService worker and the editor drive it: 32-sample host blocks into
+// both taps, then produceFrame() and fetchPaths() once per 60 Hz frame at
+// 48 kHz. malloc, calloc and realloc are hooked for the whole process, so
+// juce::Path and juce::AudioBuffer growth (HeapBlock, not operator new) count
+// too. The first frames may allocate while each path and buffer in rotation
+// gets its storage; after that nothing should.
+// Fails if any frame after the warm-up allocates, or no paths were made.
+// Linux (glibc) only, for the hook. Build with the plugin's include paths and
+// optimisation flags, linked against the JUCE modules the plugin uses
+// (juce_core, juce_events, juce_graphics, juce_dsp).
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+
+static std::atomic<bool> counting { false };
+static std::atomic<long> allocations { 0 };
+
+extern "C" void* malloc(size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+int main()
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int hostBlockSize = 32;
+    constexpr int samplesPerFrame = 800; // 48 kHz at 60 Hz
+    constexpr int warmUpFrames = 20;
+    constexpr int numFrames = 600;
+
+    SingleChannelSampleFifo<juce::AudioBuffer<float>> left { Channel::Left }, right { Channel::Right };
+    left.prepare(512);
+    right.prepare(512);
+
+    PathProducer producer(left, right);
+    producer.setView({ 0.0f, 0.0f, 600.0f, 300.0f }, sampleRate);
+
+    juce::AudioBuffer<float> block(2, hostBlockSize);
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+
+    long written = 0, framesWithPaths = 0, worstFrame = 0, allocatingFrames = 0;
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        // The audio thread's share of the frame.
+        for (int done = 0; done < samplesPerFrame; done += hostBlockSize, written += hostBlockSize)
+        {
+            for (int i = 0; i < hostBlockSize; ++i)
+            {
+                const auto tone = static_cast<float>(0.5 * std::sin(2.0 * juce::MathConstants<double>::pi * 1000.0 * (written + i) / sampleRate));
+                block.setSample(0, i, tone + noise(rng));
+                block.setSample(1, i, noise(rng));
+            }
+
+            left.update(block);
+            right.update(block);
+        }
+
+        // The worker's frame and the editor's timer tick.
+        allocations.store(0);
+        counting.store(true);
+        producer.produceFrame();
+        const bool fetched = producer.fetchPaths();
+        counting.store(false);
+
+        if (fetched && ! producer.getPath(0).isEmpty() && ! producer.getPath(1).isEmpty())
+            ++framesWithPaths;
+
+        if (frame >= warmUpFrames && allocations.load() > 0)
+        {
+            ++allocatingFrames;
+            worstFrame = std::max(worstFrame, allocations.load());
+        }
+    }
+
+    const bool ok = allocatingFrames == 0 && framesWithPaths > 0;
+    std::cout << numFrames << " frames, " << framesWithPaths << " with new paths; after " << warmUpFrames
+              << " frames of warm-up " << allocatingFrames << " frames allocated (at most " << worstFrame
+              << " times)" << (ok ? "" : "  FAILED") << std::endl;
+
+    return ok ? 0 : 1;
+}
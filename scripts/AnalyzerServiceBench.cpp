@@ -0,0 +1,133 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AnalyzerService.h"
+
+// Scheduling of the shared AnalyzerService, with stand-in clients that spin
+// for a fixed time per frame instead of running FFTs. Light load: 4 clients
+// at 50 us a frame, which should all get the full frame rate. Overload: 40
+// clients at 200 us a frame (8 ms a pass against a 4 ms budget at 60 Hz and
+// the default 25% cap), which should all slow down alike. Then clients
+// leaving and joining while it runs. Prints frames per second per client
+// (fewest and most), the time actually spent rendering as a share of one
+// core, and the service's own getLoad().
+// Fails if a client under overload gets under 80% of the frames the busiest
+// one gets, the measured load goes more than 10% over the cap, or a removed
+// client is called after removeClient() returns.
+// Build with the plugin's include paths and optimisation flags, e.g.
+// -O3 -Isource -Imodules (no kernel files needed).
+
+using Clock = std::chrono::steady_clock;
+
+struct SpinClient : AnalyzerService::Client
+{
+    explicit SpinClient(std::chrono::microseconds cost) : frameCost(cost) {}
+
+    void produceFrame() override
+    {
+        const auto start = Clock::now();
+        while (Clock::now() - start < frameCost) {}
+
+        busy.fetch_add((Clock::now() - start).count());
+        frames.fetch_add(1);
+        if (removed.load())
+            calledAfterRemoval.store(true);
+    }
+
+    std::chrono::microseconds frameCost;
+    std::atomic<long> frames { 0 };
+    std::atomic<long long> busy { 0 };
+    std::atomic<bool> removed { false }, calledAfterRemoval { false };
+};
+
+static bool run(const char* name, int numClients, std::chrono::microseconds frameCost, bool expectFullRate)
+{
+    constexpr double seconds = 2.0;
+
+    auto service = AnalyzerService::getShared();
+    std::vector<std::unique_ptr<SpinClient>> clients;
+    for (int i = 0; i < numClients; ++i)
+    {
+        clients.push_back(std::make_unique<SpinClient>(frameCost));
+        service->addClient(*clients.back());
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+
+    for (auto& client : clients)
+    {
+        service->removeClient(*client);
+        client->removed.store(true);
+    }
+
+    long fewest = clients.front()->frames.load(), most = fewest;
+    long long busy = 0;
+    bool calledAfterRemoval = false;
+    for (auto& client : clients)
+    {
+        fewest = std::min(fewest, client->frames.load());
+        most = std::max(most, client->frames.load());
+        busy += client->busy.load();
+        calledAfterRemoval = calledAfterRemoval || client->calledAfterRemoval.load();
+    }
+
+    const double measuredLoad = std::chrono::duration<double>(Clock::duration(busy)).count() / seconds;
+    const bool fair = fewest >= 0.8 * most && (! expectFullRate || fewest >= 0.8 * AnalyzerService::defaultFrameRateHz * seconds);
+    const bool capped = measuredLoad <= AnalyzerService::defaultMaxLoad * 1.1;
+    const bool ok = fair && capped && ! calledAfterRemoval;
+
+    std::cout << name << ": " << numClients << " clients at " << frameCost.count() << " us/frame: "
+              << fewest / seconds << " to " << most / seconds << " frames/s each, load " << measuredLoad
+              << " (reported " << service->getLoad() << ", cap " << AnalyzerService::defaultMaxLoad << ")"
+              << (ok ? "" : "  FAILED") << std::endl;
+
+    return ok;
+}
+
+// Clients come and go while the worker runs.
+static bool churn()
+{
+    auto service = AnalyzerService::getShared();
+    std::vector<std::unique_ptr<SpinClient>> clients;
+    bool ok = true;
+
+    for (int round = 0; round < 200; ++round)
+    {
+        clients.push_back(std::make_unique<SpinClient>(std::chrono::microseconds(100)));
+        service->addClient(*clients.back());
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+        if (clients.size() > 8)
+        {
+            auto& leaving = clients[static_cast<size_t>(round) % clients.size()];
+            service->removeClient(*leaving);
+            leaving->removed.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ok = ok && ! leaving->calledAfterRemoval.load();
+            clients.erase(clients.begin() + static_cast<long>(static_cast<size_t>(round) % clients.size()));
+        }
+    }
+
+    for (auto& client : clients)
+        service->removeClient(*client);
+
+    std::cout << "churn: 200 clients added, " << 200 - clients.size() << " removed while running"
+              << (ok ? "" : "  FAILED") << std::endl;
+    return ok;
+}
+
+int main()
+{
+    // Held for the whole run, so every stage shares one worker.
+    auto service = AnalyzerService::getShared();
+
+    bool ok = run("light", 4, std::chrono::microseconds(50), true);
+    ok = run("overload", 40, std::chrono::microseconds(200), false) && ok;
+    ok = churn() && ok;
+
+    return ok ? 0 : 1;
+}
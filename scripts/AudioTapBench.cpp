@@ -0,0 +1,172 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SPSC.h"
+
+// The analyzer tap (SingleChannelSampleFifo in SPSC.h) as PluginProcessor
+// feeds it. Integrity: a writer pushes a counting signal in blocks of
+// 32 to 65536 samples (larger than the ring) while a reader thread takes
+// 512-sample blocks; every block read must continue the count from the last
+// one, unless samples were dropped in between, and samples read plus dropped
+// must add up to samples written. Speed: update() per sample for float and
+// double blocks, against a plain memcpy of the same block, with the ring
+// drained between blocks so nothing is dropped. Also polls a tap before
+// prepare(), as the editor can before the host prepares the plugin, and
+// checks that discardUntil() leaves only what was written after the position.
+// Fails if a block read is out of sequence, the counts don't add up, the
+// unprepared tap reports a block, or the discard leaves the wrong samples.
+// Build with the plugin's include paths and optimisation flags, e.g.
+// -O3 -Isource -Imodules (no kernel files needed).
+
+using Tap = SingleChannelSampleFifo<juce::AudioBuffer<float>>;
+
+static constexpr int readBlockSize = 512;
+
+static bool checkIntegrity()
+{
+    Tap tap { Channel::Left };
+    tap.prepare(readBlockSize);
+
+    // Counting modulo 2^24, which floats hold exactly.
+    constexpr long modulus = 1L << 24;
+    constexpr int blockSizes[] = { 32, 480, 512, 1000, 4096, 65536 };
+
+    std::atomic<bool> done { false };
+    long read = 0, outOfSequence = 0, gaps = 0;
+    std::thread reader([&]
+    {
+        juce::AudioBuffer<float> block;
+        long expected = -1;
+        for (;;)
+        {
+            const bool finished = done.load();
+            while (tap.getAudioBuffer(block))
+            {
+                // Within a block the count runs on; between blocks it may skip ahead past a drop.
+                const long first = static_cast<long>(block.getSample(0, 0));
+                if (expected >= 0 && first != expected)
+                    ++gaps;
+                for (int i = 1; i < block.getNumSamples(); ++i)
+                    outOfSequence += static_cast<long>(block.getSample(0, i)) != (first + i) % modulus ? 1 : 0;
+
+                expected = (first + block.getNumSamples()) % modulus;
+                read += block.getNumSamples();
+            }
+
+            if (finished)
+                break;
+            std::this_thread::yield();
+        }
+    });
+
+    long written = 0;
+    juce::AudioBuffer<float> buffer(2, 65536);
+    for (int round = 0; round < 200; ++round)
+    {
+        const int numSamples = blockSizes[round % std::size(blockSizes)];
+        buffer.setSize(2, numSamples, false, false, true);
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(1, i, static_cast<float>((written + i) % modulus));
+
+        tap.update(buffer);
+        written += numSamples;
+
+        if (round % 8 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    done.store(true);
+    reader.join();
+
+    // What's left in the ring is less than one read block.
+    const long dropped = static_cast<long>(tap.getNumDroppedSamples());
+    const long left = written - read - dropped;
+    const bool ok = outOfSequence == 0 && left >= 0 && left < readBlockSize && (dropped > 0 || gaps == 0);
+    std::cout << written << " samples written, " << read << " read, " << dropped << " dropped (" << gaps
+              << " gaps), " << left << " left; " << outOfSequence << " out of sequence" << (ok ? "" : "  FAILED")
+              << std::endl;
+
+    return ok;
+}
+
+static bool checkAttach()
+{
+    Tap tap { Channel::Left };
+    juce::AudioBuffer<float> block;
+    const bool unpreparedEmpty = tap.getNumCompleteBuffersAvailable() == 0 && ! tap.getAudioBuffer(block);
+
+    tap.prepare(readBlockSize);
+    juce::AudioBuffer<float> buffer(2, 3000);
+    for (int i = 0; i < 3000; ++i)
+        buffer.setSample(1, i, static_cast<float>(i));
+
+    // Stale audio from before the reader attached, then the first fresh block.
+    tap.update(buffer);
+    tap.discardUntil(tap.getWritePosition());
+    const bool discarded = tap.getNumCompleteBuffersAvailable() == 0;
+
+    buffer.setSize(2, readBlockSize, false, false, true);
+    for (int i = 0; i < readBlockSize; ++i)
+        buffer.setSample(1, i, static_cast<float>(10000 + i));
+    tap.update(buffer);
+    const bool fresh = tap.getAudioBuffer(block) && block.getSample(0, 0) == 10000.0f
+                       && tap.getNumCompleteBuffersAvailable() == 0;
+
+    const bool ok = unpreparedEmpty && discarded && fresh;
+    std::cout << "unprepared tap " << (unpreparedEmpty ? "empty" : "NOT empty") << ", stale audio "
+              << (discarded && fresh ? "discarded" : "NOT discarded") << (ok ? "" : "  FAILED") << std::endl;
+    return ok;
+}
+
+template <typename SampleType>
+static void reportSpeed(int blockSize)
+{
+    constexpr int numRuns = 20000;
+
+    Tap tap { Channel::Left };
+    tap.prepare(readBlockSize);
+
+    juce::AudioBuffer<SampleType> buffer(2, blockSize);
+    for (int i = 0; i < blockSize; ++i)
+        buffer.setSample(1, i, static_cast<SampleType>(i) * SampleType(1.0e-4));
+
+    juce::AudioBuffer<float> block;
+    std::vector<float> copy(static_cast<size_t>(blockSize));
+
+    double tapNs = 0.0, copyNs = 0.0;
+    for (int run = 0; run < numRuns; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        tap.update(buffer);
+        tapNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::memcpy(copy.data(), buffer.getReadPointer(1), static_cast<size_t>(blockSize) * sizeof(float));
+        copyNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        while (tap.getAudioBuffer(block)) {}
+    }
+
+    const double samples = static_cast<double>(numRuns) * blockSize;
+    std::cout << (sizeof(SampleType) == 4 ? "float " : "double") << " blocks of " << blockSize << ": update() "
+              << tapNs / samples << " ns/sample, memcpy " << copyNs / samples << " ns/sample; "
+              << tap.getNumDroppedSamples() << " dropped" << (copy[1] == 0.0f ? " " : "") << std::endl;
+}
+
+int main()
+{
+    bool ok = checkIntegrity();
+    ok = checkAttach() && ok;
+
+    for (int blockSize : { 64, 512, 4096 })
+    {
+        reportSpeed<float>(blockSize);
+        reportSpeed<double>(blockSize);
+    }
+
+    return ok ? 0 : 1;
+}
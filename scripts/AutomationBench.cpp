@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+
+// CPU cost of the band chain under continuous automation, for per-sample
+// coefficient updates and for control intervals of 16/32/64 samples with
+// linear coefficient ramps (Engine::setControlInterval).
+// Every block retargets all three bands, so the smoothers never settle.
+// Also prints how far each interval's output strays from the per-sample one
+// and the peak output level of both, and fails if any output goes non-finite
+// (the ramps' stability guard).
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 256;
+static constexpr int numBlocks = 8000;
+
+struct Run
+{
+    double nsPerSample = 0.0;
+    std::vector<float> output; // channel 0, the whole run
+};
+
+template <typename Topology>
+static Run run(int controlInterval, double smoothingMs, float sweepOctaves)
+{
+    Cascade<float, Topology> cascade;
+    cascade.prepare(sampleRate, blockSize);
+    cascade.setControlInterval(controlInterval);
+
+    for (int b = 0; b < cascade.getNumBands(); ++b)
+        cascade.getBand(b).prepare(sampleRate, blockSize, smoothingMs);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> sweep(-sweepOctaves, sweepOctaves);
+    std::uniform_real_distribution<float> gain(-12.0f, 12.0f);
+
+    Run result;
+    result.output.reserve(static_cast<size_t>(numBlocks) * blockSize);
+
+    double totalNs = 0.0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, noise(rng));
+
+        cascade.getBand(0).setParameters(std::min(8000.0f * std::exp2(sweep(rng)), 20000.0f), gain(rng), 0.707f, FilterType::HighShelf);
+        cascade.getBand(1).setParameters(1000.0f * std::exp2(sweep(rng)), gain(rng), 2.0f, FilterType::Peaking);
+        cascade.getBand(2).setParameters(200.0f * std::exp2(sweep(rng)), gain(rng), 0.707f, FilterType::LowShelf);
+
+        const auto start = std::chrono::steady_clock::now();
+        cascade.processBlock(buffer);
+        const auto stop = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(stop - start).count();
+
+        for (int i = 0; i < blockSize; ++i)
+            result.output.push_back(buffer.getSample(0, i));
+    }
+
+    result.nsPerSample = totalNs / (static_cast<double>(numBlocks) * blockSize);
+    return result;
+}
+
+static double peak(const Run& r)
+{
+    double level = 0.0;
+    for (const float x : r.output)
+        level = std::max(level, static_cast<double>(std::abs(x)));
+
+    return level;
+}
+
+template <typename Topology>
+static bool report()
+{
+    bool ok = true;
+
+    // 20 ms glides over +/-1 octave, then 1 ms glides over +/-3 octaves (high
+    // shelf capped at 20 kHz), where the coefficients move fast enough for the
+    // guard to matter. A 1 ms glide is shorter than the longer intervals, so
+    // the diff there mostly shows the coarser control rate.
+    for (const auto& [smoothingMs, octaves] : { std::pair { 20.0, 1.0f }, std::pair { 1.0, 3.0f } })
+    {
+        const Run reference = run<Topology>(1, smoothingMs, octaves);
+        std::cout << "  " << Topology::name << ", " << smoothingMs << " ms glides: per-sample "
+                  << reference.nsPerSample << " ns/sample, peak " << peak(reference) << std::endl;
+
+        for (int interval : { 16, 32, 64 })
+        {
+            const Run ramped = run<Topology>(interval, smoothingMs, octaves);
+
+            double maxDiff = 0.0;
+            bool finite = true;
+            for (size_t i = 0; i < ramped.output.size(); ++i)
+            {
+                finite = finite && std::isfinite(ramped.output[i]);
+                maxDiff = std::max(maxDiff, static_cast<double>(std::abs(ramped.output[i] - reference.output[i])));
+            }
+
+            std::cout << "    every " << interval << ": " << ramped.nsPerSample << " ns/sample ("
+                      << reference.nsPerSample / ramped.nsPerSample << "x), max diff " << maxDiff
+                      << ", peak " << peak(ramped) << std::endl;
+
+            if (! finite)
+            {
+                std::cerr << Topology::name << " went unstable at interval " << interval << "." << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    bool ok = report<DF2T>();
+    ok = report<DF1>() && ok;
+    ok = report<TPTSVF>() && ok;
+    ok = report<Lattice>() && ok;
+
+    return ok ? 0 : 1;
+}
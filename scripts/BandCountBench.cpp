@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+
+// Cost of the fused chain against the number of bands, 1 to Cascade::maxBands.
+// Every band is set away from unity so none is skipped, so each count runs
+// the unrolled kernel built for it. Prints ns per stereo sample for the fused
+// and per-band modes, then a straight-line fit of the fused cost from 3 bands
+// up: the cost per band (the slope), the fixed cost of a pass over the buffer
+// (the intercept), and how far any count is from the line.
+// Fails if the fused output differs from the per-band one at any count, or
+// the skewed pipeline (where the vector holds the bands) from the fused one.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 4096;
+static constexpr int numBlocks = 400;
+
+// Peaks and shelves spread over the range, alternating boost and cut.
+static void setBands(Cascade<float>& cascade, int numBands)
+{
+    cascade.setNumBands(numBands);
+    for (int b = 0; b < numBands; ++b)
+    {
+        const float frequency = 30.0f * std::pow(600.0f, (b + 0.5f) / static_cast<float>(numBands));
+        const float gainDB = (b % 2 == 0 ? 3.0f : -2.0f) + 0.25f * static_cast<float>(b);
+        const FilterType type = b == 0 ? FilterType::LowShelf : b == numBands - 1 ? FilterType::HighShelf : FilterType::Peaking;
+        cascade.getBand(b).setParametersImmediate(frequency, gainDB, 1.0f, type);
+    }
+}
+
+static double run(CascadeMode mode, int numBands, juce::AudioBuffer<float>& out)
+{
+    Cascade<float> cascade;
+    cascade.setMode(mode);
+    cascade.prepare(sampleRate, blockSize);
+    setBands(cascade, numBands);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    double totalNs = 0.0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, dist(rng));
+
+        const auto start = std::chrono::steady_clock::now();
+        cascade.processBlock(buffer);
+        const auto stop = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    out.makeCopyOf(buffer);
+    return totalNs / (static_cast<double>(numBlocks) * blockSize);
+}
+
+int main()
+{
+    bool ok = true;
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    std::vector<double> counts, costs;
+    for (int numBands = 1; numBands <= Cascade<float>::maxBands; ++numBands)
+    {
+        juce::AudioBuffer<float> perBandOut, fusedOut, skewedOut;
+        const double perBand = run(CascadeMode::PerBand, numBands, perBandOut);
+        const double fused = run(CascadeMode::Fused, numBands, fusedOut);
+
+        // Same ticks in the same order: the outputs must match exactly.
+        bool same = true;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                same = same && perBandOut.getSample(ch, i) == fusedOut.getSample(ch, i);
+
+        // The skewed pipeline, where one vector holds every band: the same ticks
+        // numBands - 1 samples later.
+        const bool skewedSupported = BiquadSkewedSIMD::isSupported(numBands);
+        if (skewedSupported)
+        {
+            run(CascadeMode::Skewed, numBands, skewedOut);
+            const int latency = numBands - 1;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = latency; i < blockSize; ++i)
+                    same = same && fusedOut.getSample(ch, i - latency) == skewedOut.getSample(ch, i);
+        }
+
+        ok = ok && same;
+        counts.push_back(numBands);
+        costs.push_back(fused);
+
+        std::cout << numBands << (numBands < 10 ? "  bands" : " bands") << "  per-band: " << perBand
+                  << " ns/sample  fused: " << fused << " ns/sample (" << perBand / fused << "x, "
+                  << fused / numBands << " per band)" << (skewedSupported ? "" : "  (no skewed at this width)")
+                  << (same ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Least squares over 3 bands and up; below that the fixed cost dominates.
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    int n = 0;
+    for (size_t k = 2; k < counts.size(); ++k, ++n)
+    {
+        sumX += counts[k];
+        sumY += costs[k];
+        sumXX += counts[k] * counts[k];
+        sumXY += counts[k] * costs[k];
+    }
+
+    const double slope = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+    const double intercept = (sumY - slope * sumX) / n;
+
+    double worstDeviation = 0.0;
+    for (size_t k = 2; k < counts.size(); ++k)
+        worstDeviation = std::max(worstDeviation, std::abs(costs[k] - (intercept + slope * counts[k])) / costs[k]);
+
+    std::cout << "fused cost ~ " << intercept << " + " << slope << " * bands ns/sample; worst count "
+              << 100.0 * worstDeviation << "% off the line; 16 bands cost " << costs.back() / costs[2]
+              << "x 3 bands" << std::endl;
+
+    if (! ok)
+    {
+        std::cerr << "Band-count kernels disagree with the per-band chain." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
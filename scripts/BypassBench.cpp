@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+#include "DSP/BypassFade.h"
+#include "DSP/Oversampler.h"
+
+// Bypass toggling as PluginProcessor::processSamples does it (BypassFade.h),
+// against the old hard switch that reset the filters on every bypassed block.
+// Music-like input (two sines and noise) is bypassed at block 40 and released
+// at block 80, mid-signal. The ideal output is a crossfade between the input
+// and a chain that never stopped; the largest difference from it shows the
+// transient each scheme leaves, for the crossfade alone and with the warm
+// restart (pre-roll). Also the cost of a fully bypassed block, and of the
+// worst block after the release against an active one, at 256 and at 32
+// samples: the pre-roll is spread over the blocks after the release, so the
+// wet path should never run more than twice a block's samples in one block.
+// Then the same toggles with a wet path that has latency (4x oversampling
+// around flat bands): with the dry path delayed to match, the output must be
+// the delayed input throughout. Fails if the warm crossfade's transient isn't
+// far below the hard switch's, if a block runs the wet path over more than
+// two blocks' worth, or if the delayed dry path doesn't line up.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int defaultBlockSize = 256;
+static constexpr int numBlocks = 160;
+
+static void setBands(Cascade<float>& cascade, bool immediate)
+{
+    auto set = [immediate](auto& band, float frequency, float gainDB, FilterType type)
+    {
+        if (immediate)
+            band.setParametersImmediate(frequency, gainDB, 0.707f, type);
+        else
+            band.setParameters(frequency, gainDB, 0.707f, type);
+    };
+
+    set(cascade.getBand(0), 8000.0f, 6.0f, FilterType::HighShelf);
+    set(cascade.getBand(1), 1000.0f, -9.0f, FilterType::Peaking);
+    set(cascade.getBand(2), 120.0f, 12.0f, FilterType::LowShelf);
+}
+
+static bool isBypassed(int block) { return block >= 40 && block < 80; }
+
+// The processor's bypass handling, cut down to one chain.
+struct FadedChain
+{
+    Cascade<float> chain;
+    BypassFade<float> fade;
+    bool filtersIdle = false;
+
+    // Samples the wet path ran in the last process() call.
+    int wetSamples = 0;
+
+    void prepare(double prerollTimeMs, int blockSize)
+    {
+        chain.prepare(sampleRate, blockSize);
+        setBands(chain, true);
+        fade.prepare(sampleRate, blockSize, 2, BypassFade<float>::defaultFadeTimeMs, prerollTimeMs);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, bool bypassed)
+    {
+        fade.setBypassed(bypassed);
+        if (fade.isBypassed())
+        {
+            if (! filtersIdle)
+            {
+                chain.reset();
+                filtersIdle = true;
+            }
+
+            process(buffer);
+            return;
+        }
+
+        setBands(chain, filtersIdle);
+        filtersIdle = false;
+        process(buffer);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        wetSamples = 0;
+        fade.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                     [this](float* const* channels, int numChannels, int numSamples)
+                     {
+                         wetSamples += numSamples;
+                         chain.processBlock(channels, numChannels, numSamples);
+                     });
+    }
+};
+
+static void makeInput(juce::AudioBuffer<float>& buffer, int block, std::mt19937& rng)
+{
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    const int blockSize = buffer.getNumSamples();
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const double t = (block * blockSize + i) / sampleRate;
+            buffer.setSample(ch, i, static_cast<float>(0.4 * std::sin(2.0 * std::numbers::pi * 110.0 * t)
+                                                       + 0.2 * std::sin(2.0 * std::numbers::pi * 2500.0 * t))
+                                        + noise(rng));
+        }
+    }
+}
+
+struct Result
+{
+    double transient = 0.0, hardTransient = 0.0, bypassedNs = 0.0, activeNs = 0.0, releaseNs = 0.0;
+    int mostWetSamples = 0;
+};
+
+static Result run(double prerollTimeMs, int blockSize = defaultBlockSize)
+{
+    FadedChain faded;
+    faded.prepare(prerollTimeMs, blockSize);
+
+    Cascade<float> hard, warm;
+    hard.prepare(sampleRate, blockSize);
+    warm.prepare(sampleRate, blockSize);
+    setBands(hard, true);
+    setBands(warm, true);
+
+    // The fade's own gain curve, for the ideal output.
+    BypassFade<float> curve;
+    curve.prepare(sampleRate, blockSize, 2, BypassFade<float>::defaultFadeTimeMs, prerollTimeMs);
+
+    std::mt19937 rng(3);
+    juce::AudioBuffer<float> input(2, blockSize), fadedOut(2, blockSize), hardOut(2, blockSize), warmOut(2, blockSize),
+        ones(2, blockSize);
+
+    Result result;
+    int numBypassedBlocks = 0, numActiveBlocks = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        makeInput(input, block, rng);
+        const bool bypassed = isBypassed(block);
+
+        fadedOut.makeCopyOf(input);
+        hardOut.makeCopyOf(input);
+        warmOut.makeCopyOf(input);
+
+        const auto start = std::chrono::steady_clock::now();
+        faded.process(fadedOut, bypassed);
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (bypassed && faded.fade.isBypassed())
+        {
+            result.bypassedNs += ns;
+            ++numBypassedBlocks;
+        }
+        else if (block >= 120)
+        {
+            result.activeNs += ns;
+            ++numActiveBlocks;
+        }
+
+        // The blocks after the release, while the pre-roll and fade run.
+        if (block >= 80 && block < 120)
+            result.releaseNs = std::max(result.releaseNs, ns);
+        result.mostWetSamples = std::max(result.mostWetSamples, faded.wetSamples);
+
+        // The old scheme: hard switch, state reset on every bypassed block.
+        if (bypassed)
+            hard.reset();
+        else
+            hard.processBlock(hardOut);
+
+        // The ideal: a chain that never stops, crossfaded with the same curve.
+        warm.processBlock(warmOut);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                ones.setSample(ch, i, 0.0f);
+        curve.setBypassed(bypassed);
+        curve.process(ones.getArrayOfWritePointers(), 2, blockSize, [](float* const* channels, int numChannels, int numSamples)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::fill(channels[ch], channels[ch] + numSamples, 1.0f);
+        });
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                // ones now holds the wet gain for each sample (0 once fully bypassed).
+                const float gain = ones.getSample(ch, i);
+                const float ideal = gain * warmOut.getSample(ch, i) + (1.0f - gain) * input.getSample(ch, i);
+                const float hardIdeal = bypassed ? input.getSample(ch, i) : warmOut.getSample(ch, i);
+
+                result.transient = std::max(result.transient, static_cast<double>(std::abs(fadedOut.getSample(ch, i) - ideal)));
+                result.hardTransient = std::max(result.hardTransient, static_cast<double>(std::abs(hardOut.getSample(ch, i) - hardIdeal)));
+            }
+        }
+    }
+
+    result.bypassedNs /= std::max(numBypassedBlocks, 1);
+    result.activeNs /= std::max(numActiveBlocks, 1);
+    return result;
+}
+
+// Bypass toggles around an oversampled wet path that changes nothing but the delay.
+static double checkLatency()
+{
+    Oversampler<float> oversampler;
+    oversampler.prepare(2);
+    oversampler.setStages(2, OversamplingPhase::Linear);
+    const int latency = oversampler.getLatencySamples();
+
+    BypassFade<float> fade;
+    fade.prepare(sampleRate, defaultBlockSize, 2);
+    fade.prepareLatency(oversampler.getMaxLatencySamples());
+    fade.setLatency(latency);
+
+    juce::AudioBuffer<float> buffer(2, defaultBlockSize);
+    std::vector<float> input, output;
+    double worst = 0.0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        // Tones only: the oversampler's filters would take the top off noise.
+        for (int i = 0; i < defaultBlockSize; ++i)
+        {
+            const double t = (block * defaultBlockSize + i) / sampleRate;
+            const float x = static_cast<float>(0.4 * std::sin(2.0 * std::numbers::pi * 110.0 * t)
+                                               + 0.2 * std::sin(2.0 * std::numbers::pi * 2500.0 * t));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+            input.push_back(x);
+        }
+
+        fade.setBypassed(isBypassed(block));
+        fade.process(buffer.getArrayOfWritePointers(), 2, defaultBlockSize, [&oversampler](float* const* channels, int numChannels, int numSamples)
+        {
+            oversampler.process(channels, numChannels, numSamples, [](float* const*, int, int) {});
+        });
+
+        for (int i = 0; i < defaultBlockSize; ++i)
+            output.push_back(buffer.getSample(1, i));
+    }
+
+    // Skip the oversampler's start-up.
+    for (size_t i = static_cast<size_t>(4 * defaultBlockSize); i < output.size(); ++i)
+        worst = std::max(worst, static_cast<double>(std::abs(output[i] - input[i - static_cast<size_t>(latency)])));
+
+    return worst;
+}
+
+int main()
+{
+    const Result cold = run(0.0);
+    const Result warm = run(BypassFade<float>::defaultPrerollTimeMs);
+    const bool transientOk = warm.transient < 0.1 * warm.hardTransient;
+    std::cout << "transient against a chain that never stopped:" << std::endl
+              << "  hard switch with resets " << warm.hardTransient << std::endl
+              << "  crossfade               " << cold.transient << std::endl
+              << "  crossfade + pre-roll    " << warm.transient << (transientOk ? "" : "  FAILED") << std::endl;
+    std::cout << "fully bypassed block " << warm.bypassedNs << " ns" << std::endl;
+
+    bool workOk = true;
+    for (int blockSize : { defaultBlockSize, 32 })
+    {
+        const Result result = run(BypassFade<float>::defaultPrerollTimeMs, blockSize);
+        const bool ok = result.mostWetSamples <= 2 * blockSize && result.transient < 0.1 * result.hardTransient;
+        std::cout << "blocks of " << blockSize << ": worst block after release " << result.releaseNs << " ns, active block "
+                  << result.activeNs << " ns; wet path ran at most " << result.mostWetSamples << " samples in a block"
+                  << (ok ? "" : "  FAILED") << std::endl;
+        workOk = workOk && ok;
+    }
+
+    const double latencyError = checkLatency();
+    std::cout << "with 4x oversampling latency, largest difference from the delayed input " << latencyError
+              << (latencyError < 1.0e-3 ? "" : "  FAILED") << std::endl;
+
+    return transientOk && workOk && latencyError < 1.0e-3 ? 0 : 1;
+}
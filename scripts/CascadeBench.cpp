@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "DSP/Cascade.h"
+
+// Times the band chain over offline-sized blocks and prints ns per stereo sample.
+// Checks the modes against each other: per-band and fused must match exactly,
+// as must the skewed pipeline with static bands (it's the same arithmetic). The
+// time-parallel kernel reassociates, so its error against a double chain is
+// printed next to the per-sample kernel's. Fails on a mismatch, or if the
+// time-parallel or automated skewed output is off by more than 1e-3 of the
+// peak: float rounding in these bands stays orders of magnitude below that,
+// while a wrong table, lane or state update is off by a good part of the signal.
+// Build with the plugin's include paths and optimisation flags plus the
+// per-ISA kernel files, with the same per-file flags as CMakeLists.txt, e.g.
+// -O3 -Isource -Imodules -Imodules/JUCE/modules source/DSP/DispatchSSE2.cpp
+// and source/DSP/DispatchAVX2.cpp (-mavx2 -mfma) / DispatchAVX512.cpp (-mavx512f -mfma)
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 4096;
+static constexpr int numBlocks = 2000;
+
+template <typename SampleType>
+static void setBands(Cascade<SampleType>& cascade, float offset)
+{
+    cascade.getBand(0).setParameters(8000.0f + offset, 6.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParameters(1000.0f + offset, -4.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParameters(200.0f + offset, 3.0f, 0.707f, FilterType::LowShelf);
+}
+
+template <typename SampleType>
+static double run(CascadeMode mode, BiquadKernel kernel, bool automate, juce::AudioBuffer<SampleType>& out)
+{
+    Cascade<SampleType> cascade;
+    cascade.setMode(mode);
+    cascade.setKernel(kernel);
+    cascade.prepare(sampleRate, blockSize);
+    setBands(cascade, 0.0f);
+
+    juce::AudioBuffer<SampleType> buffer(2, blockSize);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    double totalNs = 0.0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, static_cast<SampleType>(dist(rng)));
+
+        // Retarget every block so the smoothers never settle.
+        if (automate)
+            setBands(cascade, static_cast<float>(block % 2) * 50.0f);
+
+        const auto start = std::chrono::steady_clock::now();
+        cascade.processBlock(buffer);
+        const auto stop = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    out.makeCopyOf(buffer);
+    return totalNs / (static_cast<double>(numBlocks) * blockSize);
+}
+
+int main()
+{
+    bool ok = true;
+
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    for (bool automate : { false, true })
+    {
+        juce::AudioBuffer<float> perBandOut, fusedOut, timeParallelOut, skewedOut;
+        juce::AudioBuffer<double> referenceOut;
+        const double perBand = run(CascadeMode::PerBand, BiquadKernel::Lanewise, automate, perBandOut);
+        const double fused = run(CascadeMode::Fused, BiquadKernel::Lanewise, automate, fusedOut);
+        const double timeParallel = run(CascadeMode::Fused, BiquadKernel::TimeParallel, automate, timeParallelOut);
+        const double skewed = run(CascadeMode::Skewed, BiquadKernel::Lanewise, automate, skewedOut);
+        run(CascadeMode::Fused, BiquadKernel::Lanewise, automate, referenceOut);
+
+        // Same arithmetic in the same order, so the outputs must match exactly.
+        // The time-parallel kernel reassociates (BiquadBlockSIMD.h); it's held
+        // to the double chain, as is the per-sample kernel for comparison.
+        // The skewed pipeline runs the same ticks, just latencySamples later; only
+        // the coefficient timing during a glide differs.
+        Cascade<float> skewedChain;
+        skewedChain.setMode(CascadeMode::Skewed);
+        const int latency = skewedChain.getLatencySamples();
+        double peak = 0.0, fusedError = 0.0, timeParallelError = 0.0, maxSkewedDiff = 0.0;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                if (perBandOut.getSample(ch, i) != fusedOut.getSample(ch, i))
+                    ok = false;
+
+                const double reference = referenceOut.getSample(ch, i);
+                peak = std::max(peak, std::abs(reference));
+                fusedError = std::max(fusedError, std::abs(fusedOut.getSample(ch, i) - reference));
+                timeParallelError = std::max(timeParallelError, std::abs(timeParallelOut.getSample(ch, i) - reference));
+
+                if (i >= latency)
+                    maxSkewedDiff = std::max(maxSkewedDiff, static_cast<double>(std::abs(fusedOut.getSample(ch, i - latency)
+                                                                                         - skewedOut.getSample(ch, i))));
+            }
+        }
+
+        const double tolerance = 1.0e-3 * peak;
+        if (timeParallelError > tolerance || maxSkewedDiff > (automate ? tolerance : 0.0))
+            ok = false;
+
+        std::cout << (automate ? "automated" : "static   ")
+                  << "  per-band: " << perBand << " ns/sample"
+                  << "  fused: " << fused << " ns/sample (" << perBand / fused << "x)"
+                  << "  time-parallel: " << timeParallel << " ns/sample (" << perBand / timeParallel << "x,"
+                  << " error " << timeParallelError << " against double, fused " << fusedError << ")"
+                  << "  skewed: " << skewed << " ns/sample (" << perBand / skewed << "x,"
+                  << " max diff " << maxSkewedDiff << ")" << std::endl;
+    }
+
+    if (!ok) {
+        std::cerr << "Cascade kernels disagree beyond tolerance." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
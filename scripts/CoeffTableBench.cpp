@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/CoeffTable.h"
+
+// Accuracy and speed of CoeffTable against Qcalc::calculate.
+// For each sample rate and slice: the largest coefficient difference and the
+// largest magnitude response difference in dB (64 log-spaced frequencies from
+// 20 Hz to just below Nyquist) over random points in the table's range, and
+// whether every interpolated design is stable. Then lookups/s against
+// designs/s, the build time, and a save/map round trip through the temp
+// directory. Fails above 0.05 dB, on an unstable design or if the mapped
+// table differs from the built one.
+// Build with the plugin's include paths and optimisation flags, e.g.
+// -O3 -Isource -Imodules (no kernel files needed).
+
+static constexpr double q = 0.707f; // PluginProcessor::defaultQ
+static constexpr int numPoints = 20000;
+
+struct Slice
+{
+    const char* name;
+    QMode mode;
+    FilterType type;
+};
+
+static constexpr Slice slices[] = {
+    { "peaking (constant Q)    ", QMode::Constant_Q, FilterType::Peaking },
+    { "peaking (proportional Q)", QMode::Proportional_Q, FilterType::Peaking },
+    { "low shelf               ", QMode::Constant_Q, FilterType::LowShelf },
+    { "high shelf              ", QMode::Constant_Q, FilterType::HighShelf },
+};
+
+struct Point
+{
+    double frequency, gainDB;
+};
+
+static std::vector<Point> makePoints(const CoeffTable& table)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> octave(0.0, std::log2(table.getTopFrequency() / CoeffTable::minFrequency));
+    std::uniform_real_distribution<double> gain(-CoeffTable::maxGainDB, CoeffTable::maxGainDB);
+
+    std::vector<Point> points;
+    for (int i = 0; i < numPoints; ++i)
+        points.push_back({ CoeffTable::minFrequency * std::exp2(octave(rng)), gain(rng) });
+
+    return points;
+}
+
+static double magnitudeDB(const BiquadCoeffs& c, double w)
+{
+    const auto z = std::polar(1.0, -w);
+    return 20.0 * std::log10(std::abs((c.b0 + c.b1 * z + c.b2 * z * z) / (1.0 + c.a1 * z + c.a2 * z * z)));
+}
+
+static bool isStable(const BiquadCoeffs& c)
+{
+    return std::abs(c.a2) < 1.0 && std::abs(c.a1) < 1.0 + c.a2;
+}
+
+static bool reportAccuracy(const CoeffTable& table)
+{
+    bool ok = true;
+    const auto points = makePoints(table);
+    const double sampleRate = table.getSampleRate();
+
+    std::vector<double> w;
+    for (int k = 0; k < 64; ++k)
+        w.push_back(2.0 * std::numbers::pi * 20.0 / sampleRate * std::pow(0.499 * sampleRate / 20.0, k / 63.0));
+
+    for (const auto& slice : slices)
+    {
+        double coeffDiff = 0.0, dbDiff = 0.0;
+        bool stable = true;
+
+        for (const auto& p : points)
+        {
+            BiquadCoeffs c;
+            table.lookup(p.frequency, p.gainDB, slice.mode, slice.type, c);
+            const auto e = Qcalc::calculate(sampleRate, p.frequency, p.gainDB, q, slice.mode, slice.type);
+
+            coeffDiff = std::max({ coeffDiff, std::abs(c.b0 - e.b0), std::abs(c.b1 - e.b1), std::abs(c.b2 - e.b2),
+                                   std::abs(c.a1 - e.a1), std::abs(c.a2 - e.a2) });
+            for (const double x : w)
+                dbDiff = std::max(dbDiff, std::abs(magnitudeDB(c, x) - magnitudeDB(e, x)));
+            stable = stable && isStable(c);
+        }
+
+        std::cout << "  " << slice.name << "  max coeff diff " << coeffDiff << ", max response diff " << dbDiff << " dB"
+                  << (stable ? "" : ", UNSTABLE") << std::endl;
+
+        if (dbDiff > 0.05 || ! stable)
+            ok = false;
+    }
+
+    return ok;
+}
+
+static void reportSpeed(const CoeffTable& table)
+{
+    const auto points = makePoints(table);
+    constexpr int numRuns = 20;
+    double sink = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < numRuns; ++run)
+        for (const auto& p : points)
+            sink += Qcalc::calculate(table.getSampleRate(), p.frequency, p.gainDB, q, QMode::Proportional_Q, FilterType::Peaking).a1;
+    const double exactNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < numRuns; ++run)
+        for (const auto& p : points)
+            sink += table.calculate(p.frequency, p.gainDB, q, QMode::Proportional_Q, FilterType::Peaking).a1;
+    const double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    const double count = static_cast<double>(numRuns) * points.size();
+    std::cout << "  Qcalc::calculate " << exactNs / count << " ns, CoeffTable::calculate " << tableNs / count
+              << " ns (" << exactNs / tableNs << "x)" << (sink == 0.0 ? " " : "") << std::endl;
+}
+
+static bool sameNodes(const CoeffTable& a, const CoeffTable& b)
+{
+    const auto points = makePoints(a);
+    for (const auto& slice : slices)
+    {
+        for (const auto& p : points)
+        {
+            BiquadCoeffs x, y;
+            a.lookup(p.frequency, p.gainDB, slice.mode, slice.type, x);
+            b.lookup(p.frequency, p.gainDB, slice.mode, slice.type, y);
+            if (std::memcmp(&x, &y, sizeof(x)) != 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory);
+
+    for (const double sampleRate : { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 })
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const CoeffTable table(sampleRate, q);
+        const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << sampleRate << " Hz (20 Hz - " << table.getTopFrequency() << " Hz, "
+                  << table.getSizeInBytes() / 1024 << " KB, built in " << buildMs << " ms)" << std::endl;
+
+        ok = reportAccuracy(table) && ok;
+        reportSpeed(table);
+
+        const auto file = directory.getChildFile(CoeffTable::getCacheFileName(sampleRate, q));
+        const bool saved = table.saveTo(file);
+        const auto loadStart = std::chrono::steady_clock::now();
+        const auto loaded = CoeffTable::loadFrom(file, sampleRate, q);
+        const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        const bool matches = saved && loaded != nullptr && loaded->isMapped() && sameNodes(table, *loaded);
+        std::cout << "  saved and mapped in " << loadMs << " ms: " << (matches ? "identical" : "FAILED") << std::endl;
+
+        // A file for another sample rate must not be picked up.
+        if (! matches || CoeffTable::loadFrom(file, sampleRate * 2.0, q) != nullptr)
+            ok = false;
+
+        file.deleteFile();
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Qcalc.h"
+
+// Verifies Qcalc::calculateFast (FastMath.h) against Qcalc::calculate.
+// First the polynomials on their own (largest relative error against libm),
+// then the designs over the whole parameter grid: 44.1-192 kHz, 20 Hz to
+// 20 kHz in 1/48 octave steps, +/-24 dB in 0.25 dB steps, a few Q/slope
+// values (shelf slopes up to 1), every filter type and Q mode. For each design the magnitude
+// responses are compared at 24 log-spaced frequencies up to Nyquist; the
+// worst difference in dB is reported per sample rate. Fails above 1e-6 dB
+// or on an unstable design. Last, designs per second for both.
+// Build with the plugin's include paths and optimisation flags, e.g.
+// -O3 -Isource -Imodules (no kernel files needed).
+
+struct Slice
+{
+    const char* name;
+    QMode mode;
+    FilterType type;
+};
+
+static constexpr Slice slices[] = {
+    { "peaking (constant Q)", QMode::Constant_Q, FilterType::Peaking },
+    { "peaking (proportional Q)", QMode::Proportional_Q, FilterType::Peaking },
+    { "low shelf", QMode::Constant_Q, FilterType::LowShelf },
+    { "high shelf", QMode::Constant_Q, FilterType::HighShelf },
+};
+
+static double relativeError(double x, double reference)
+{
+    return std::abs(x - reference) / std::abs(reference);
+}
+
+static void reportFunctions()
+{
+    constexpr int numPoints = 1000000;
+    double exp2Error = 0.0, dbError = 0.0, sinError = 0.0, cosError = 0.0;
+
+    for (int i = 0; i <= numPoints; ++i)
+    {
+        const double u = static_cast<double>(i) / numPoints;
+
+        exp2Error = std::max(exp2Error, relativeError(FastMath::exp2(-20.0 + 40.0 * u), std::exp2(-20.0 + 40.0 * u)));
+
+        const double gainDB = -48.0 + 96.0 * u;
+        dbError = std::max(dbError, relativeError(FastMath::dbToA(gainDB), std::pow(10.0, gainDB / 40.0)));
+
+        // Down to 1e-9 rad, where only a relative bound keeps 1 - cos(w0) usable.
+        // Near pi/2 the cosine is only as good as pi/2 - x, so stop at 1.5.
+        const double x = 0.5 * std::numbers::pi * std::pow(u, 4.0) + 1.0e-9;
+        double s, c;
+        FastMath::sinCos(x, s, c);
+        sinError = std::max(sinError, relativeError(s, std::sin(x)));
+        if (x < 1.5)
+            cosError = std::max(cosError, relativeError(c, std::cos(x)));
+    }
+
+    std::cout << "max relative error: exp2 " << exp2Error << ", dbToA " << dbError
+              << ", sin " << sinError << ", cos " << cosError << std::endl;
+}
+
+static bool isStable(const BiquadCoeffs& c)
+{
+    return std::abs(c.a2) < 1.0 && std::abs(c.a1) < 1.0 + c.a2;
+}
+
+static double squaredMagnitude(const BiquadCoeffs& c, std::complex<double> z)
+{
+    return std::norm((c.b0 + c.b1 * z + c.b2 * z * z) / (1.0 + c.a1 * z + c.a2 * z * z));
+}
+
+static bool reportGrid(double sampleRate)
+{
+    std::vector<std::complex<double>> points;
+    for (int k = 0; k < 24; ++k)
+        points.push_back(std::polar(1.0, -2.0 * std::numbers::pi * 10.0 / sampleRate * std::pow(0.4999 * sampleRate / 10.0, k / 23.0)));
+
+    bool ok = true;
+    std::cout << sampleRate << " Hz" << std::endl;
+
+    for (const auto& slice : slices)
+    {
+        double worstDB = 0.0, worstCoeff = 0.0;
+        bool stable = true;
+
+        for (int octaveStep = 0; octaveStep <= 48 * 10; ++octaveStep)
+        {
+            const double frequency = std::min(20.0 * std::exp2(octaveStep / 48.0), 20000.0);
+            if (frequency >= 0.5 * sampleRate)
+                break;
+
+            for (int gainStep = -96; gainStep <= 96; ++gainStep)
+            {
+                // Shelf slopes above 1 are clamped to a pole on the unit circle.
+                const double maxQ = slice.type == FilterType::Peaking ? 5.0 : 1.0;
+                for (const double q : { 0.2, static_cast<double>(0.707f), maxQ })
+                {
+                    const double gainDB = gainStep * 0.25;
+                    const auto exact = Qcalc::calculate(sampleRate, frequency, gainDB, q, slice.mode, slice.type);
+                    const auto fast = Qcalc::calculateFast(sampleRate, frequency, gainDB, q, slice.mode, slice.type);
+
+                    for (const auto z : points)
+                        worstDB = std::max(worstDB, std::abs(10.0 * std::log10(squaredMagnitude(fast, z) / squaredMagnitude(exact, z))));
+
+                    worstCoeff = std::max({ worstCoeff, std::abs(fast.b0 - exact.b0), std::abs(fast.b1 - exact.b1),
+                                            std::abs(fast.b2 - exact.b2), std::abs(fast.a1 - exact.a1), std::abs(fast.a2 - exact.a2) });
+                    stable = stable && isStable(fast);
+                }
+            }
+        }
+
+        std::cout << "  " << slice.name << ": max response diff " << worstDB << " dB, max coeff diff " << worstCoeff
+                  << (stable ? "" : ", UNSTABLE") << std::endl;
+
+        if (worstDB > 1.0e-6 || ! stable)
+            ok = false;
+    }
+
+    return ok;
+}
+
+static void reportSpeed()
+{
+    constexpr int numDesigns = 4096;
+    constexpr int numRuns = 200;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> octave(0.0, std::log2(1000.0));
+    std::uniform_real_distribution<double> gain(-24.0, 24.0);
+    std::uniform_int_distribution<int> type(0, 2);
+
+    std::vector<double> frequency, gainDB;
+    std::vector<FilterType> types;
+    for (int i = 0; i < numDesigns; ++i)
+    {
+        frequency.push_back(20.0 * std::exp2(octave(rng)));
+        gainDB.push_back(gain(rng));
+        types.push_back(static_cast<FilterType>(type(rng)));
+    }
+
+    auto time = [&](auto design)
+    {
+        double sink = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < numRuns; ++run)
+            for (int i = 0; i < numDesigns; ++i)
+                sink += design(48000.0, frequency[i], gainDB[i], 0.707, QMode::Proportional_Q, types[i]).a1;
+        const auto stop = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(stop - start).count() / (numDesigns * static_cast<double>(numRuns))
+               + (sink == 0.0 ? 1.0e-300 : 0.0);
+    };
+
+    const double exactNs = time(Qcalc::calculate);
+    const double fastNs = time(Qcalc::calculateFast);
+    std::cout << "calculate " << exactNs << " ns, calculateFast " << fastNs << " ns (" << exactNs / fastNs << "x)" << std::endl;
+}
+
+int main()
+{
+    reportFunctions();
+
+    bool ok = true;
+    for (const double sampleRate : { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 })
+        ok = reportGrid(sampleRate) && ok;
+
+    reportSpeed();
+
+    return ok ? 0 : 1;
+}
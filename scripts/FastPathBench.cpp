@@ -0,0 +1,183 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DSP/Cascade.h"
+
+// The skip paths of Engine/Cascade: unity bands and silent input.
+// First ns per stereo sample with 0 to 3 bands parked at 0 dB and for
+// silence, with the skip counters. Then a run through every transition
+// (a band gliding to 0 dB and back, noise stopping and restarting, a
+// cleared buffer) in each mode and for mono, compared against the same chain
+// with the skip paths off. Fails if the two differ by more than the
+// decayed tails that get dropped, or if a skip path never ran.
+// Build with the plugin's include paths and optimisation flags plus the
+// per-ISA kernel files, with the same per-file flags as CMakeLists.txt, e.g.
+// -O3 -Isource -Imodules -Imodules/JUCE/modules source/DSP/DispatchSSE2.cpp
+// and source/DSP/DispatchAVX2.cpp (-mavx2 -mfma) / DispatchAVX512.cpp (-mavx512f -mfma)
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 512;
+
+template <typename Chain>
+static void setBands(Chain& chain, int numParked, float midGainDB = -4.0f)
+{
+    chain.getBand(0).setParameters(8000.0f, numParked > 2 ? 0.0f : 6.0f, 0.707f, FilterType::HighShelf);
+    chain.getBand(1).setParameters(1000.0f, numParked > 0 ? 0.0f : midGainDB, 0.707f, FilterType::Peaking);
+    chain.getBand(2).setParameters(200.0f, numParked > 1 ? 0.0f : 3.0f, 0.707f, FilterType::LowShelf);
+}
+
+template <typename T>
+static void fillNoise(juce::AudioBuffer<T>& buffer, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, static_cast<T>(dist(rng)));
+}
+
+static void reportSpeed()
+{
+    constexpr int numBlocks = 4000;
+
+    for (int numParked = -1; numParked <= 3; ++numParked)
+    {
+        Cascade<float> cascade;
+        cascade.prepare(sampleRate, blockSize);
+        setBands(cascade, std::max(numParked, 0));
+
+        juce::AudioBuffer<float> input(2, blockSize), buffer(2, blockSize);
+        std::mt19937 rng(1);
+        fillNoise(input, rng);
+        if (numParked < 0)
+            input.clear();
+
+        double totalNs = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            // A fresh copy, without the cleared flag.
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, input, ch, 0, blockSize);
+
+            const auto start = std::chrono::steady_clock::now();
+            cascade.processBlock(buffer);
+            totalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::uint64_t identitySkips = 0;
+        for (int b = 0; b < 3; ++b)
+            identitySkips += cascade.getBand(b).getFastPathCounters().identitySkips.load();
+
+        std::cout << (numParked < 0 ? "silence         " : std::to_string(numParked) + " bands at 0 dB ")
+                  << totalNs / (numBlocks * static_cast<double>(blockSize)) << " ns/sample, "
+                  << "band skips " << identitySkips << ", chain silence skips "
+                  << cascade.getFastPathCounters().silenceSkips.load() << " of " << numBlocks << " blocks" << std::endl;
+    }
+}
+
+// Block by block: noise, the mid band gliding to 0 dB and settling, silence,
+// a cleared buffer, noise again, and the mid band leaving 0 dB.
+template <typename T>
+static void makeBlock(int block, juce::AudioBuffer<T>& buffer, std::mt19937& rng)
+{
+    if (block >= 60 && block < 80)
+    {
+        buffer.clear();
+        if (block >= 70)
+            buffer.setSample(0, 0, T(0)); // drops the cleared flag, still silent
+    }
+    else
+    {
+        fillNoise(buffer, rng);
+    }
+}
+
+static float gainForBlock(int block)
+{
+    return block < 10 ? -4.0f : block < 100 ? 0.0f : 5.0f;
+}
+
+static bool checkTransitions(CascadeMode mode, BiquadKernel kernel, int numChannels, const char* name)
+{
+    constexpr int numBlocks = 120;
+
+    Cascade<float> cascade;
+    cascade.setMode(mode);
+    cascade.setKernel(kernel);
+    cascade.prepare(sampleRate, blockSize, numChannels);
+    setBands(cascade, 0);
+
+    Cascade<float> reference;
+    reference.setMode(mode);
+    reference.setKernel(kernel);
+    reference.setFastPathsEnabled(false);
+    reference.prepare(sampleRate, blockSize, numChannels);
+    setBands(reference, 0);
+
+    std::mt19937 rng(7), referenceRng(7);
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::AudioBuffer<float> expected(numChannels, blockSize);
+    std::vector<std::vector<double>> output(static_cast<size_t>(numChannels)), referenceOutput(static_cast<size_t>(numChannels));
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        setBands(cascade, 0, gainForBlock(block));
+        setBands(reference, 0, gainForBlock(block));
+
+        makeBlock(block, buffer, rng);
+        makeBlock(block, expected, referenceRng);
+
+        cascade.processBlock(buffer);
+        reference.processBlock(expected);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                output[static_cast<size_t>(ch)].push_back(buffer.getSample(ch, i));
+                referenceOutput[static_cast<size_t>(ch)].push_back(expected.getSample(ch, i));
+            }
+        }
+    }
+
+    double maxDiff = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (size_t i = 0; i < output[static_cast<size_t>(ch)].size(); ++i)
+            maxDiff = std::max(maxDiff, std::abs(output[static_cast<size_t>(ch)][i] - referenceOutput[static_cast<size_t>(ch)][i]));
+
+    std::uint64_t identitySkips = 0, silenceSkips = cascade.getFastPathCounters().silenceSkips.load();
+    for (int b = 0; b < 3; ++b)
+    {
+        identitySkips += cascade.getBand(b).getFastPathCounters().identitySkips.load();
+        silenceSkips += cascade.getBand(b).getFastPathCounters().silenceSkips.load();
+    }
+
+    // The skewed mode runs the full chain; the others must have used both paths.
+    const bool skipped = mode == CascadeMode::Skewed && numChannels == 2 ? true : identitySkips > 0 && silenceSkips > 0;
+    const bool ok = maxDiff < 1.0e-6 && skipped;
+
+    std::cout << name << ": max diff " << maxDiff << ", band skips " << identitySkips << ", silence skips "
+              << silenceSkips << (ok ? "" : "  FAILED") << std::endl;
+
+    return ok;
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    reportSpeed();
+
+    bool ok = true;
+    ok = checkTransitions(CascadeMode::PerBand, BiquadKernel::Lanewise, 2, "per band   ") && ok;
+    ok = checkTransitions(CascadeMode::Fused, BiquadKernel::Lanewise, 2, "fused      ") && ok;
+    ok = checkTransitions(CascadeMode::Fused, BiquadKernel::Lanewise, 1, "fused mono ") && ok;
+    ok = checkTransitions(CascadeMode::Fused, BiquadKernel::Lanewise, 6, "fused 5.1  ") && ok;
+    ok = checkTransitions(CascadeMode::Fused, BiquadKernel::TimeParallel, 2, "tiled      ") && ok;
+    ok = checkTransitions(CascadeMode::Skewed, BiquadKernel::Lanewise, 2, "skewed     ") && ok;
+
+    return ok ? 0 : 1;
+}
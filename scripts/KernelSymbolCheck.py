@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+Checks the per-ISA kernel objects (source/DSP/Dispatch*.cpp, see rule 2 in
+BiquadKernels.h) for code the linker could share with the rest of the plugin.
+
+Every function such an object defines should be an instantiation for its own
+arch, so its name mentions the arch: avx512f in DispatchAVX512, avx2 in
+DispatchAVX2, and so on. Anything else (an inline helper, a constructor, a
+std:: template on plain types) is a weak symbol the linker may pick from the
+wide-ISA object for every caller, which faults on CPUs without that ISA.
+Lists the offending symbols per object.
+Fails if any object defines code that doesn't name its arch.
+Run on the object files of a build, e.g.
+    python3 scripts/KernelSymbolCheck.py $(find build -name 'Dispatch*.o')
+Needs an nm that demangles (-C): GNU binutils or llvm-nm. ELF and Mach-O only.
+"""
+
+import re
+import subprocess
+import sys
+
+# Object file name -> text every symbol it defines must contain.
+ARCHS = {
+    "DispatchAVX512": "avx512f",
+    "DispatchAVX2": "avx2",
+    "DispatchSSE2": "sse2",
+    "DispatchNEON": "neon64",
+}
+
+# Code symbols: strong and weak text. Data (guard variables, personality
+# references) can't fault, so it isn't checked.
+CODE_TYPES = {"T", "t", "W"}
+
+
+def arch_of(path):
+    for name, arch in ARCHS.items():
+        if re.search(name + r"\.cpp\.(o|obj)$|" + name + r"\.(o|obj)$", path):
+            return arch
+    return None
+
+
+def foreign_symbols(path, arch):
+    output = subprocess.run(["nm", "-C", "--defined-only", path],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        parts = line.split(" ", 2)
+        if len(parts) < 3 or parts[1] not in CODE_TYPES:
+            continue
+
+        name = parts[2]
+        # Local labels and static helpers can't be shared.
+        if parts[1] == "t" or name.startswith("."):
+            continue
+
+        if arch not in name:
+            symbols.append(name)
+
+    return symbols
+
+
+def main(paths):
+    if not paths:
+        print(__doc__)
+        return 2
+
+    ok = True
+    for path in paths:
+        arch = arch_of(path)
+        if arch is None:
+            print(f"{path}: not a Dispatch*.cpp object, skipped")
+            continue
+
+        foreign = foreign_symbols(path, arch)
+        print(f"{path} ({arch}): {len(foreign)} shared symbols" + ("" if not foreign else "  FAILED"))
+        for name in foreign:
+            print(f"    {name}")
+
+        ok = ok and not foreign
+
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,238 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+
+#include "DSP/Cascade.h"
+#include "DSP/Oversampler.h"
+
+// Oversampler.h at every factor, for both filter kinds. First the filters:
+// passband gain from 100 Hz to 20 kHz, the images the upsampler leaves above
+// the base Nyquist, the aliases the downsampler lets back in from above it,
+// and whether getLatencySamples() matches the measured delay. Then the cost
+// per stereo sample, up and down alone and around the three-band cascade
+// running at the high rate. Fails if a filter misses the spec or the
+// reported latency is off.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 512;
+
+static const char* phaseName(OversamplingPhase phase)
+{
+    return phase == OversamplingPhase::Linear ? "linear " : "minimum";
+}
+
+static void fillSine(juce::AudioBuffer<double>& buffer, double frequency, double rate, long offset)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(ch, i, std::sin(2.0 * std::numbers::pi * frequency * static_cast<double>(offset + i) / rate));
+}
+
+// Amplitude and phase of `frequency` in x (a whole number of periods or long enough).
+static void fitSine(const std::vector<double>& x, double frequency, double rate, double& amplitude, double& phase)
+{
+    double s = 0.0, c = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        const double w = 2.0 * std::numbers::pi * frequency * static_cast<double>(i) / rate;
+        s += x[i] * std::sin(w);
+        c += x[i] * std::cos(w);
+    }
+
+    amplitude = 2.0 * std::hypot(s, c) / static_cast<double>(x.size());
+    phase = std::atan2(c, s);
+}
+
+struct Run
+{
+    std::vector<double> output, top;
+};
+
+// Run a sine through the oversampler; `replace` substitutes the high-rate signal.
+template <typename Replace>
+static Run runSine(Oversampler<double>& os, double frequency, int numBlocks, Replace&& replace)
+{
+    os.reset();
+    juce::AudioBuffer<double> buffer(2, blockSize);
+    Run run;
+    long topPosition = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        fillSine(buffer, frequency, sampleRate, static_cast<long>(block) * blockSize);
+        os.process(buffer, [&](juce::AudioBuffer<double>& high)
+        {
+            replace(high, topPosition);
+            for (int i = 0; i < high.getNumSamples(); ++i)
+                run.top.push_back(high.getSample(0, i));
+            topPosition += high.getNumSamples();
+        });
+
+        for (int i = 0; i < blockSize; ++i)
+            run.output.push_back(buffer.getSample(1, i));
+    }
+
+    return run;
+}
+
+// The nearest frequency with a whole number of periods in `numSamples`, so the fits don't leak.
+static double onBin(double frequency, int numSamples)
+{
+    const double spacing = sampleRate / numSamples;
+    return std::round(frequency / spacing) * spacing;
+}
+
+static double toDB(double x) { return 20.0 * std::log10(std::max(x, 1.0e-30)); }
+
+static bool checkFilters(int numStages, OversamplingPhase phase)
+{
+    Oversampler<double> os;
+    os.prepare(2);
+    os.setStages(numStages, phase);
+
+    const int factor = os.getFactor();
+    const double topRate = sampleRate * factor;
+    const int settle = 8; // blocks thrown away
+    auto nothing = [](juce::AudioBuffer<double>&, long) {};
+
+    auto steady = [settle](const std::vector<double>& x, size_t rateScale)
+    {
+        return std::vector<double>(x.begin() + static_cast<long>(settle * blockSize * rateScale), x.end());
+    };
+
+    // Passband: gain at a few frequencies, worst deviation in dB.
+    double ripple = 0.0;
+    for (double wanted : { 100.0, 1000.0, 10000.0, 18000.0, 20000.0 })
+    {
+        const double f = onBin(wanted, 16 * blockSize);
+        double amplitude, ph;
+        fitSine(steady(runSine(os, f, 24, nothing).output, 1), f, sampleRate, amplitude, ph);
+        ripple = std::max(ripple, std::abs(toDB(amplitude)));
+    }
+
+    // Images: a 20 kHz tone at the high rate, everything but it.
+    double image = 0.0;
+    {
+        const double f = onBin(20000.0, 16 * blockSize);
+        const Run run = runSine(os, f, 24, nothing);
+        const std::vector<double> top = steady(run.top, static_cast<size_t>(factor));
+
+        double amplitude, ph;
+        fitSine(top, f, topRate, amplitude, ph);
+
+        double residual = 0.0;
+        for (size_t i = 0; i < top.size(); ++i)
+        {
+            const double w = 2.0 * std::numbers::pi * f * static_cast<double>(i) / topRate;
+            residual = std::max(residual, std::abs(top[i] - amplitude * std::sin(w + ph)));
+        }
+        image = residual;
+    }
+
+    // Aliases: replace the high-rate signal by a tone just above 0.55 of the
+    // base rate; nothing of it may come back down.
+    double alias = 0.0;
+    {
+        const double f = 0.56 * sampleRate;
+        const Run run = runSine(os, 1000.0, 24, [&](juce::AudioBuffer<double>& high, long position)
+        {
+            for (int ch = 0; ch < high.getNumChannels(); ++ch)
+                for (int i = 0; i < high.getNumSamples(); ++i)
+                    high.setSample(ch, i, std::sin(2.0 * std::numbers::pi * f * static_cast<double>(position + i) / topRate));
+        });
+
+        for (double x : steady(run.output, 1))
+            alias = std::max(alias, std::abs(x));
+    }
+
+    // Latency: the phase delay of a 375 Hz tone.
+    double measuredLatency = 0.0;
+    {
+        double inAmplitude, inPhase, outAmplitude, outPhase;
+        std::vector<double> input;
+        for (int i = 0; i < 16 * blockSize; ++i)
+            input.push_back(std::sin(2.0 * std::numbers::pi * 375.0 * i / sampleRate));
+
+        const Run run = runSine(os, 375.0, 16, nothing);
+        fitSine(steady(input, 1), 375.0, sampleRate, inAmplitude, inPhase);
+        fitSine(steady(run.output, 1), 375.0, sampleRate, outAmplitude, outPhase);
+
+        double lag = inPhase - outPhase;
+        while (lag < 0.0)
+            lag += 2.0 * std::numbers::pi;
+        measuredLatency = lag / (2.0 * std::numbers::pi * 375.0) * sampleRate;
+    }
+
+    const bool latencyOk = std::abs(measuredLatency - os.getLatencySamples()) < (phase == OversamplingPhase::Linear ? 0.01 : 0.5);
+    const bool ok = ripple < 0.1 && toDB(image) < -90.0 && toDB(alias) < -90.0 && latencyOk;
+
+    std::cout << factor << "x " << phaseName(phase) << ": passband " << ripple << " dB, images " << toDB(image)
+              << " dB, aliases " << toDB(alias) << " dB, latency " << os.getLatencySamples() << " (measured "
+              << measuredLatency << ")" << (ok ? "" : "  FAILED") << std::endl;
+
+    return ok;
+}
+
+static void reportSpeed(int numStages, OversamplingPhase phase)
+{
+    constexpr int numBlocks = 2000;
+
+    Oversampler<float> os;
+    os.prepare(2);
+    os.setStages(numStages, phase);
+
+    Cascade<float> cascade;
+    cascade.prepare(sampleRate * os.getFactor(), Oversampler<float>::chunkSize * os.getFactor());
+    cascade.getBand(0).setParametersImmediate(8000.0f, 6.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParametersImmediate(1000.0f, -4.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParametersImmediate(200.0f, 3.0f, 0.707f, FilterType::LowShelf);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    double resampleNs = 0.0, totalNs = 0.0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, dist(rng));
+
+            const auto start = std::chrono::steady_clock::now();
+            if (pass == 0)
+                os.process(buffer, [](juce::AudioBuffer<float>&) {});
+            else
+                os.process(buffer, [&cascade](juce::AudioBuffer<float>& high) { cascade.processBlock(high); });
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+            (pass == 0 ? resampleNs : totalNs) += ns;
+        }
+    }
+
+    const double samples = numBlocks * static_cast<double>(blockSize);
+    std::cout << os.getFactor() << "x " << (numStages == 0 ? "       " : phaseName(phase)) << ": up/down "
+              << resampleNs / samples << " ns/sample, with cascade " << totalNs / samples << " ns/sample" << std::endl;
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    bool ok = true;
+    for (auto phase : { OversamplingPhase::Linear, OversamplingPhase::Minimum })
+        for (int numStages = 1; numStages <= Oversampler<double>::maxStages; ++numStages)
+            ok = checkFilters(numStages, phase) && ok;
+
+    reportSpeed(0, OversamplingPhase::Linear);
+    for (auto phase : { OversamplingPhase::Linear, OversamplingPhase::Minimum })
+        for (int numStages = 1; numStages <= Oversampler<float>::maxStages; ++numStages)
+            reportSpeed(numStages, phase);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+
+// Compares the float and double processing paths: ns per stereo sample, and the
+// error of each against a long double DF2T for a low shelf at a high sample rate.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr int blockSize = 4096;
+static constexpr int numBlocks = 2000;
+
+template <typename SampleType>
+static void setBands(Cascade<SampleType>& cascade, float offset)
+{
+    cascade.getBand(0).setParameters(8000.0f + offset, 6.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParameters(1000.0f + offset, -4.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParameters(200.0f + offset, 3.0f, 0.707f, FilterType::LowShelf);
+}
+
+template <typename SampleType>
+static double timeChain(bool automate)
+{
+    Cascade<SampleType> cascade;
+    cascade.prepare(48000.0, blockSize);
+    setBands(cascade, 0.0f);
+
+    juce::AudioBuffer<SampleType> buffer(2, blockSize);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<SampleType> dist(-1, 1);
+
+    double totalNs = 0.0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, dist(rng));
+
+        if (automate)
+            setBands(cascade, static_cast<float>(block % 2) * 50.0f);
+
+        const auto start = std::chrono::steady_clock::now();
+        cascade.processBlock(buffer);
+        const auto stop = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    return totalNs / (static_cast<double>(numBlocks) * blockSize);
+}
+
+// Peak error in dBFS of one path against the long double reference for a
+// 30 Hz +12 dB low shelf at 192 kHz, fed with 10 s of white noise at -6 dBFS.
+template <typename SampleType>
+static double shelfErrorDB()
+{
+    constexpr double sampleRate = 192000.0;
+    constexpr int length = 192000 * 10;
+
+    const auto c = Qcalc::calculate(sampleRate, 30.0, 12.0, 0.707, QMode::Constant_Q, FilterType::LowShelf);
+
+    Cascade<SampleType> cascade;
+    cascade.prepare(sampleRate, blockSize, 1);
+    cascade.getBand(0).setParametersImmediate(20000.0f, 0.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParametersImmediate(1000.0f, 0.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParametersImmediate(30.0f, 12.0f, 0.707f, FilterType::LowShelf);
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<double> dist(-0.5, 0.5);
+
+    long double z1 = 0.0L, z2 = 0.0L;
+    double maxError = 0.0;
+
+    juce::AudioBuffer<SampleType> buffer(1, blockSize);
+    std::vector<double> input(blockSize);
+
+    for (int start = 0; start < length; start += blockSize)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            // Quantise the input to SampleType so both sides see the same signal.
+            input[static_cast<size_t>(i)] = static_cast<double>(static_cast<SampleType>(dist(rng)));
+            buffer.setSample(0, i, static_cast<SampleType>(input[static_cast<size_t>(i)]));
+        }
+
+        cascade.processBlock(buffer);
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            // The other two bands are at 0 dB, i.e. exactly unity.
+            const long double x = input[static_cast<size_t>(i)];
+            const long double y = x * c.b0 + z1;
+            z1 = (x * c.b1 + z2) - (y * c.a1);
+            z2 = (x * c.b2) - (y * c.a2);
+
+            maxError = std::max(maxError, std::abs(static_cast<double>(y) - static_cast<double>(buffer.getSample(0, i))));
+        }
+    }
+
+    return 20.0 * std::log10(std::max(maxError, 1.0e-300));
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    for (bool automate : { false, true })
+    {
+        const double f32 = timeChain<float>(automate);
+        const double f64 = timeChain<double>(automate);
+
+        std::cout << (automate ? "automated" : "static   ")
+                  << "  f32: " << f32 << " ns/sample"
+                  << "  f64: " << f64 << " ns/sample (" << f64 / f32 << "x)" << std::endl;
+    }
+
+    const double errorF32 = shelfErrorDB<float>();
+    const double errorF64 = shelfErrorDB<double>();
+
+    std::cout << "30 Hz low shelf @ 192 kHz, peak error: f32 " << errorF32 << " dBFS, f64 "
+              << errorF64 << " dBFS" << std::endl;
+
+    // The double path has to be clearly better, or it isn't worth its cost.
+    if (errorF64 > errorF32 - 60.0) {
+        std::cerr << "Double path is not meaningfully more accurate." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
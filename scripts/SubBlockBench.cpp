@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+#include "Utils/ParameterEvents.h"
+
+// Cost of sample-accurate automation: the band chain run through
+// processWithEvents() (Utils/ParameterEvents.h) the way PluginProcessor runs
+// it, with 4096-sample blocks and timestamped gain and frequency changes every
+// N samples, from none up to one per sample, for cuts at least 1, 16, 32
+// (the plugin's minSubBlock) and 64 samples apart. Prints ns per stereo
+// sample and sub-blocks per block for each, against the same events applied
+// at block starts. Sparse events cost more split than at block starts: the
+// bands glide after each one instead of once per block, so the fast path is
+// off more of the time. Splitting itself shows with dense events.
+// Also checks that the cuts are exact: events every 1000 samples with
+// cuts allowed anywhere must give the same output as setting the band by
+// hand at those samples, and a run with the events queued but no settings
+// changed must match the unsplit one. Fails if either differs.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 4096;
+static constexpr int numBlocks = 200;
+
+using Queue = ParameterEventQueue<8192>;
+
+struct Run
+{
+    double nsPerSample = 0.0;
+    double subBlocksPerBlock = 0.0;
+    std::vector<float> output; // channel 0, the whole run
+};
+
+// Events alternate between band 1's gain and frequency.
+static void apply(Cascade<float>& cascade, const ParameterEvent& event)
+{
+    auto& band = cascade.getBand(1);
+    const float frequency = event.parameter == 1 ? event.value : 1000.0f;
+    const float gainDB = event.parameter == 0 ? event.value : 6.0f;
+    band.setParameters(frequency, gainDB, 0.707f, FilterType::Peaking);
+}
+
+static void prepare(Cascade<float>& cascade)
+{
+    cascade.prepare(sampleRate, blockSize);
+    cascade.getBand(0).setParametersImmediate(8000.0f, 3.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParametersImmediate(1000.0f, 6.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParametersImmediate(200.0f, -3.0f, 0.707f, FilterType::LowShelf);
+}
+
+static float eventValue(long n, bool changing)
+{
+    if (! changing)
+        return n % 2 == 0 ? 6.0f : 1000.0f;
+
+    return n % 2 == 0 ? static_cast<float>(-12.0 + 24.0 * std::fmod(n * 0.37, 1.0))
+                      : static_cast<float>(300.0 * std::exp2(3.0 * std::fmod(n * 0.61, 1.0)));
+}
+
+// interval 0 = no events.
+static Run run(int interval, int minSubBlock, bool changing = true)
+{
+    Cascade<float> cascade;
+    prepare(cascade);
+
+    Queue queue;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::vector<float*> channels(2);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    Run result;
+    long numSubBlocks = 0, nextEvent = interval, eventCount = 0;
+    double totalNs = 0.0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        const std::int64_t blockStart = static_cast<std::int64_t>(block) * blockSize;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, noise(rng));
+
+        // This block's automation points, queued as a host would before the call.
+        for (; interval > 0 && nextEvent < blockStart + blockSize; nextEvent += interval, ++eventCount)
+            queue.push({ nextEvent, static_cast<int>(eventCount % 2), eventValue(eventCount, changing) });
+
+        const auto start = std::chrono::steady_clock::now();
+        numSubBlocks += processWithEvents(queue, blockStart, blockSize, minSubBlock,
+                                          [&](const ParameterEvent& e) { apply(cascade, e); },
+                                          [&](int offset, int length)
+                                          {
+                                              if (length == blockSize)
+                                              {
+                                                  cascade.processBlock(buffer);
+                                                  return;
+                                              }
+
+                                              for (int ch = 0; ch < 2; ++ch)
+                                                  channels[static_cast<size_t>(ch)] = buffer.getWritePointer(ch, offset);
+
+                                              cascade.processBlock(channels.data(), 2, length);
+                                          });
+        totalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        for (int i = 0; i < blockSize; ++i)
+            result.output.push_back(buffer.getSample(0, i));
+    }
+
+    result.nsPerSample = totalNs / (static_cast<double>(numBlocks) * blockSize);
+    result.subBlocksPerBlock = static_cast<double>(numSubBlocks) / numBlocks;
+    return result;
+}
+
+// The same events applied by hand: the blocks cut at every event sample.
+static std::vector<float> reference(int interval)
+{
+    Cascade<float> cascade;
+    prepare(cascade);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    std::vector<float*> channels(2);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    std::vector<float> output;
+    long nextEvent = interval, eventCount = 0;
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        const long blockStart = static_cast<long>(block) * blockSize;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, noise(rng));
+
+        for (int offset = 0; offset < blockSize;)
+        {
+            while (nextEvent == blockStart + offset)
+            {
+                apply(cascade, { nextEvent, static_cast<int>(eventCount % 2), eventValue(eventCount, true) });
+                nextEvent += interval;
+                ++eventCount;
+            }
+
+            const int length = static_cast<int>(std::min<long>(nextEvent - blockStart, blockSize)) - offset;
+            for (int ch = 0; ch < 2; ++ch)
+                channels[static_cast<size_t>(ch)] = buffer.getWritePointer(ch, offset);
+
+            cascade.processBlock(channels.data(), 2, length);
+            offset += length;
+        }
+
+        for (int i = 0; i < blockSize; ++i)
+            output.push_back(buffer.getSample(0, i));
+    }
+
+    return output;
+}
+
+static double maxDiff(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        diff = std::max(diff, static_cast<double>(std::abs(a[i] - b[i])));
+
+    return diff;
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    const Run unsplit = run(0, 32);
+    std::cout << "no events: " << unsplit.nsPerSample << " ns/sample" << std::endl;
+
+    // Cuts at least a block apart apply every event at the next block start,
+    // as before: the same smoothing work, no splitting.
+    for (int interval : { 1024, 256, 64, 16, 1 })
+    {
+        const Run quantised = run(interval, blockSize);
+        std::cout << "event every " << interval << (interval == 1 ? " sample" : " samples") << ", per block: "
+                  << quantised.nsPerSample << " ns;";
+        for (int minSubBlock : { 1, 16, 32, 64 })
+        {
+            const Run split = run(interval, minSubBlock);
+            std::cout << "  cuts >= " << minSubBlock << ": " << split.nsPerSample << " ns ("
+                      << split.nsPerSample / quantised.nsPerSample << "x, " << split.subBlocksPerBlock << " pieces)";
+        }
+        std::cout << std::endl;
+    }
+
+    // Exactness: events where they're due, and cuts alone change nothing.
+    const double eventDiff = maxDiff(run(1000, 1).output, reference(1000));
+    const double cutDiff = maxDiff(run(100, 32, false).output, unsplit.output);
+    std::cout << "events on their samples vs by hand: max diff " << eventDiff
+              << "; cut without changes vs unsplit: max diff " << cutDiff << std::endl;
+
+    if (eventDiff != 0.0 || cutDiff != 0.0)
+    {
+        std::cerr << "Sub-block splitting changed the output." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DSP/Cascade.h"
+
+// Times the band chain for every filter structure in Topology.h, float and
+// double, and checks that each one realises the same filter: with static
+// parameters every structure has to match the double DF2T chain. While
+// automating, the structures legitimately differ (their states react
+// differently to moving coefficients), so that difference is only printed.
+// Build like CascadeBench.cpp (same include paths and per-ISA kernel files).
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 4096;
+static constexpr int numBlocks = 500;
+
+template <typename Chain>
+static void setBands(Chain& cascade, float offset)
+{
+    cascade.getBand(0).setParameters(8000.0f + offset, 6.0f, 0.707f, FilterType::HighShelf);
+    cascade.getBand(1).setParameters(1000.0f + offset, -4.0f, 0.707f, FilterType::Peaking);
+    cascade.getBand(2).setParameters(200.0f + offset, 3.0f, 0.707f, FilterType::LowShelf);
+}
+
+struct Result
+{
+    double nsPerSample = 0.0;
+    std::vector<double> output; // first block of channel 0..numChannels-1, concatenated
+};
+
+template <typename SampleType, typename Topology>
+static Result run(bool automate, int numChannels)
+{
+    Cascade<SampleType, Topology> cascade;
+    cascade.prepare(sampleRate, blockSize, numChannels);
+    setBands(cascade, 0.0f);
+
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> dist(-0.5, 0.5);
+
+    Result result;
+    double totalNs = 0.0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, static_cast<SampleType>(static_cast<float>(dist(rng))));
+
+        if (automate)
+            setBands(cascade, static_cast<float>(block % 2) * 50.0f);
+
+        const auto start = std::chrono::steady_clock::now();
+        cascade.processBlock(buffer);
+        const auto stop = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(stop - start).count();
+
+        // Past the initial 20 ms glide from the default parameters.
+        if (block == 1)
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    result.output.push_back(static_cast<double>(buffer.getSample(ch, i)));
+    }
+
+    result.nsPerSample = totalNs / (static_cast<double>(numBlocks) * blockSize);
+    return result;
+}
+
+static double maxDiff(const Result& a, const Result& b)
+{
+    double diff = 0.0;
+    for (size_t i = 0; i < a.output.size(); ++i)
+        diff = std::max(diff, std::abs(a.output[i] - b.output[i]));
+
+    return diff;
+}
+
+template <typename Topology>
+static bool report(int numChannels)
+{
+    bool ok = true;
+
+    for (bool automate : { false, true })
+    {
+        const Result reference = run<double, DF2T>(automate, numChannels);
+        const Result f32 = run<float, Topology>(automate, numChannels);
+        const Result f64 = run<double, Topology>(automate, numChannels);
+
+        const double diff32 = maxDiff(f32, reference);
+        const double diff64 = maxDiff(f64, reference);
+
+        std::cout << "  " << Topology::name << (automate ? " automated" : " static   ")
+                  << "  f32: " << f32.nsPerSample << " ns/sample (max diff " << diff32 << ")"
+                  << "  f64: " << f64.nsPerSample << " ns/sample (max diff " << diff64 << ")" << std::endl;
+
+        // Full-scale noise through three bands of at most 6 dB: rounding alone
+        // stays many orders below these bounds, a structure that realises
+        // another filter is off by a good part of the signal.
+        if (! automate && (diff64 > 1.0e-9 || diff32 > 1.0e-3))
+        {
+            std::cerr << Topology::name << " does not match DF2T." << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+int main()
+{
+    std::cout << "kernels: " << Dispatch::getActiveKernelName() << std::endl;
+
+    bool ok = true;
+    for (int numChannels : { 2, 1 })
+    {
+        std::cout << (numChannels == 2 ? "stereo" : "mono") << std::endl;
+        ok = report<DF2T>(numChannels) && ok;
+        ok = report<DF1>(numChannels) && ok;
+        ok = report<TPTSVF>(numChannels) && ok;
+        ok = report<Lattice>(numChannels) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
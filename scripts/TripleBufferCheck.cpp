@@ -0,0 +1,119 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "Utils/TripleBuffer.h"
+
+// TripleBuffer.h as PluginProcessor uses it for the parameter snapshot. A
+// writer thread publishes snapshots as fast as it can, each one filled with a
+// single counter value, until the reader has pulled 200000 of them (or five
+// seconds pass); the reader pulls them in a loop and checks that every
+// field of what it reads holds the same value (nothing torn) and that the
+// values only go up (nothing stale after something newer). Then the cost of
+// pull() with nothing new, which is what the audio thread pays per block while
+// nobody touches a control, and of a pull() and read of a fresh snapshot.
+// Fails if a snapshot is torn or out of order, or the last one never arrives.
+// Build with the plugin's include paths and optimisation flags, e.g.
+// -O3 -Isource -Imodules (no kernel files needed).
+
+// About the size of PluginProcessor::ParameterSnapshot.
+struct Snapshot
+{
+    std::array<long, 52> values {};
+};
+
+static bool checkHandoff()
+{
+    constexpr long wantedPulls = 200000;
+    constexpr auto timeLimit = std::chrono::seconds(5);
+
+    TripleBuffer<Snapshot> buffer;
+    std::atomic<bool> stop { false };
+    std::atomic<long> published { 0 };
+
+    // Publishes until the reader has seen enough, then says how many it published.
+    std::thread writer([&]
+    {
+        long n = 0;
+        while (! stop.load(std::memory_order_relaxed))
+        {
+            ++n;
+            auto& snapshot = buffer.getWriteBuffer();
+            for (auto& value : snapshot.values)
+                value = n;
+            buffer.publish();
+        }
+        published.store(n);
+    });
+
+    long pulls = 0, torn = 0, backwards = 0, last = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        // Once the writer has stopped, one more pull takes its last publish.
+        const long total = published.load();
+        if (buffer.pull())
+        {
+            ++pulls;
+            const auto& snapshot = buffer.read();
+            const long value = snapshot.values.front();
+            for (const long v : snapshot.values)
+                torn += v != value ? 1 : 0;
+            backwards += value <= last ? 1 : 0;
+            last = value;
+        }
+
+        if (total != 0)
+            break;
+
+        if (pulls >= wantedPulls || std::chrono::steady_clock::now() - start > timeLimit)
+            stop.store(true, std::memory_order_relaxed);
+    }
+
+    writer.join();
+
+    const long total = published.load();
+    const bool ok = torn == 0 && backwards == 0 && pulls > 1 && last == total;
+    std::cout << total << " publishes, " << pulls << " new snapshots pulled, last " << last << ", " << torn
+              << " torn fields, " << backwards << " out of order" << (ok ? "" : "  FAILED") << std::endl;
+
+    return ok;
+}
+
+static void reportSpeed()
+{
+    constexpr int numRuns = 10000000;
+
+    TripleBuffer<Snapshot> buffer;
+    buffer.publish();
+    buffer.pull();
+
+    long sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < numRuns; ++run)
+        sink += buffer.pull() ? 1 : 0;
+    const double idleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / numRuns;
+
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < numRuns; ++run)
+    {
+        buffer.getWriteBuffer().values[0] = run;
+        buffer.publish();
+        if (buffer.pull())
+            sink += buffer.read().values[0];
+    }
+    const double freshNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / numRuns;
+
+    std::cout << "pull() with nothing new " << idleNs << " ns, publish() and pull() of a new snapshot " << freshNs
+              << " ns" << (sink == 0 ? " " : "") << std::endl;
+}
+
+int main()
+{
+    const bool ok = checkHandoff();
+    reportSpeed();
+
+    return ok ? 0 : 1;
+}
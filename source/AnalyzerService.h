@@ -0,0 +1,187 @@
+#pragma once
+
+#ifndef BIQUAD3_ANALYZERSERVICE_H
+#define BIQUAD3_ANALYZERSERVICE_H
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * One background thread that renders the spectrum analyzer for every open
+ * editor in the process, so the FFTs don't run on the message thread and
+ * forty editors don't mean forty 60 Hz timers doing them.
+ *
+ * Editors register a Client for their analyzer. Each frame period the
+ * worker goes round the clients, giving each one frame in turn; a pass that
+ * runs out of CPU budget stops there and the next pass starts with the client
+ * that missed out, so under load every client slows down alike rather than
+ * the last ones starving. The budget caps the whole analyzer at maxLoad of
+ * one core, however many instances are open.
+ */
+class AnalyzerService {
+public:
+    /** Something that renders a frame on the worker thread. */
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        /** Render the next frame, if there's new input. Called on the worker thread. */
+        virtual void produceFrame() = 0;
+    };
+
+    static constexpr double defaultFrameRateHz = 60.0;
+    static constexpr double defaultMaxLoad = 0.25;
+
+    AnalyzerService() : worker(*this) { worker.startThread(); }
+    ~AnalyzerService()
+    {
+        worker.signalThreadShouldExit();
+        worker.notify();
+        worker.stopThread(1000);
+    }
+
+    /**
+     * The service shared by the whole process, started the first time it's
+     * asked for and stopped when the last holder lets go.
+     */
+    static std::shared_ptr<AnalyzerService> getShared()
+    {
+        static std::mutex sharedLock;
+        static std::weak_ptr<AnalyzerService> shared;
+
+        const std::scoped_lock lock(sharedLock);
+        auto service = shared.lock();
+        if (service == nullptr)
+        {
+            service = std::make_shared<AnalyzerService>();
+            shared = service;
+        }
+
+        return service;
+    }
+
+    /** Start rendering frames for `client`. */
+    void addClient(Client& client)
+    {
+        {
+            const std::scoped_lock lock(clientsLock);
+            clients.push_back(&client);
+        }
+        worker.notify();
+    }
+
+    /**
+     * Stop rendering for `client`. Once this returns the worker isn't in
+     * its produceFrame() and won't call it again.
+     */
+    void removeClient(Client& client)
+    {
+        const std::scoped_lock lock(clientsLock);
+        const auto it = std::find(clients.begin(), clients.end(), &client);
+        if (it == clients.end())
+            return;
+
+        // Whoever was next keeps their turn.
+        const auto index = static_cast<size_t>(it - clients.begin());
+        clients.erase(it);
+        if (index < nextClient)
+            --nextClient;
+        if (nextClient >= clients.size())
+            nextClient = 0;
+    }
+
+    /** Frames per second each client is offered. */
+    void setFrameRate(double hz) { frameRateHz.store(std::max(hz, 1.0)); }
+
+    /** Share of one core the analyzer may use (0-1). */
+    void setMaxLoad(double load) { maxLoad.store(std::clamp(load, 0.01, 1.0)); }
+
+    /** Share of one core the worker spent rendering, averaged over the last second or so. */
+    double getLoad() const { return load.load(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // One pass round the clients, stopping once the budget is spent.
+    // @return the time spent rendering
+    Clock::duration runPass(Clock::duration budget)
+    {
+        const auto start = Clock::now();
+        const std::scoped_lock lock(clientsLock);
+
+        for (size_t done = 0; done < clients.size(); ++done)
+        {
+            if (Clock::now() - start >= budget)
+                break;
+
+            clients[nextClient]->produceFrame();
+            nextClient = (nextClient + 1) % clients.size();
+        }
+
+        return Clock::now() - start;
+    }
+
+    void run(juce::Thread& thread)
+    {
+        using namespace std::chrono;
+
+        while (! thread.threadShouldExit())
+        {
+            const auto period = duration_cast<Clock::duration>(duration<double>(1.0 / frameRateHz.load()));
+            const auto budget = duration_cast<Clock::duration>(period * maxLoad.load());
+
+            bool idle = false;
+            {
+                const std::scoped_lock lock(clientsLock);
+                idle = clients.empty();
+            }
+
+            if (idle)
+            {
+                load.store(0.0);
+                thread.wait(-1);
+                continue;
+            }
+
+            const auto busy = runPass(budget);
+
+            // A pass that overran the budget (one slow frame) is paid back by
+            // waiting longer, so the cap holds on average.
+            const auto rest = std::max(period - busy, duration_cast<Clock::duration>(busy / maxLoad.load() - busy));
+            const double busyShare = duration<double>(busy).count() / duration<double>(busy + rest).count();
+            load.store(load.load() + loadSmoothing * (busyShare - load.load()));
+
+            thread.wait(duration<double, std::milli>(rest).count());
+        }
+    }
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(AnalyzerService& s) : juce::Thread("Spectrum analyzer"), service(s) {}
+        void run() override { service.run(*this); }
+
+    private:
+        AnalyzerService& service;
+    };
+
+    // About a second's worth of passes at 60 Hz.
+    static constexpr double loadSmoothing = 1.0 / 60.0;
+
+    std::mutex clientsLock;
+    std::vector<Client*> clients;
+    size_t nextClient = 0;
+
+    std::atomic<double> frameRateHz { defaultFrameRateHz };
+    std::atomic<double> maxLoad { defaultMaxLoad };
+    std::atomic<double> load { 0.0 };
+
+    Worker worker;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#pragma once
+
+#ifndef BIQUAD3_BIQUADBLOCKSIMD_H
+#define BIQUAD3_BIQUADBLOCKSIMD_H
+
+#include <array>
+#include "BiquadSIMD.h"
+#include "Qcalc.h"
+
+/*
+ * Time-parallel DF2T biquad (block state-space / look-ahead form).
+ *
+ * BiquadSIMD puts one channel per lane, so a stereo EQ only ever touches two lanes:
+ * half an SSE register, a quarter of AVX, an eighth of AVX-512. Here the lanes hold
+ * consecutive samples of ONE channel instead, so every lane does useful work.
+ *
+ * Written as a state-space system, DF2T is
+ *
+ *     s[n+1] = A s[n] + B x[n],   y[n] = C s[n] + D x[n]
+ *
+ *     A = | -a1  1 |   B = | b1 - a1*b0 |   C = | 1  0 |   D = b0
+ *         | -a2  0 |       | b2 - a2*b0 |
+ *
+ * Unrolling it over a block of W samples gives every output directly from the
+ * state at the start of the block and the W inputs:
+ *
+ *     y[k] = (C A^k) s[0] + sum_{j<=k} h[k-j] x[j]
+ *
+ * where h is the impulse response (h[0] = D, h[m] = C A^(m-1) B). The two row
+ * vectors C A^k and the W shifted copies of h are precomputed per coefficient set,
+ * so a block costs W broadcast-FMAs plus two for the state, for W samples.
+ * The state for the next block falls straight out of the last two in/out pairs,
+ * which is the ordinary DF2T update written without the intermediate z2.
+ *
+ * Precision: the sums are reassociated compared with the sample-by-sample
+ * recursion, so results are not bit-identical. Each output is a sum of W + 2
+ * float products instead of DF2T's few operations per sample, so its rounding
+ * error grows with W and with the filter's noise gain (worst for low shelves
+ * at high sample rates, where float DF2T is itself least accurate).
+ * CascadeBench.cpp prints it against a double chain, next to the per-sample
+ * kernel's, for whichever kernel set is active. The error doesn't accumulate
+ * over time because the state is rebuilt with the regular DF2T update at the
+ * end of every block.
+ *
+ * W is the lane count of the dispatched kernel set (4 for SSE2/NEON, 8 for
+ * AVX2, 16 for AVX-512), so the tables are built for whichever one is active.
+ * Rebuilding them is O(W^2), so Engine only uses this kernel while the
+ * parameters are steady; during smoothing it falls back to per-sample updates.
+ */
+class BiquadBlockSIMD {
+public:
+    BiquadBlockSIMD() { setCoeffs({ 1.0, 0.0, 0.0, 0.0, 0.0 }); }
+
+    /**
+     * Store new coefficients. The block tables are rebuilt lazily on the next
+     * processBlock(), so calling this every sample while smoothing is cheap.
+     */
+    void setCoeffs(const BiquadCoeffs& newCoeffs) noexcept
+    {
+        coeffs = newCoeffs;
+        tablesDirty = true;
+    }
+
+    /**
+     * Process any number of channels in place, one channel at a time. The delay
+     * lines are BiquadSIMD's (one slot per channel), so an Engine can switch
+     * between the two kernels at any block boundary without a discontinuity.
+     */
+    void processBlock(float* const* channelData, int numChannels, int numSamples,
+                      BiquadSIMD<float>& stateOwner) noexcept
+    {
+        if (channelData == nullptr || numSamples <= 0)
+            return;
+
+        const KernelTable& kernels = Dispatch::getKernels();
+
+        // The block length is the active kernel's lane count.
+        if (tablesDirty || tables.width != kernels.lanes)
+            rebuildTables(kernels.lanes);
+
+        kernels.timeParallel(tables, stateOwner.getLanes(), channelData,
+                             std::min(numChannels, BiquadSIMD<float>::maxChannels), numSamples);
+    }
+
+private:
+    void rebuildTables(int width) noexcept
+    {
+        const double b0 = coeffs.b0, b1 = coeffs.b1, b2 = coeffs.b2, a1 = coeffs.a1, a2 = coeffs.a2;
+        tables.b0 = static_cast<float>(b0);
+        tables.b1 = static_cast<float>(b1);
+        tables.b2 = static_cast<float>(b2);
+        tables.a1 = static_cast<float>(a1);
+        tables.a2 = static_cast<float>(a2);
+
+        // Rows of C A^k, accumulated in double: r_{k+1} = r_k A.
+        const double B1 = b1 - a1 * b0;
+        const double B2 = b2 - a2 * b0;
+
+        std::array<double, maxKernelLanes> rowA{}, rowB{}, h{};
+        double r0 = 1.0, r1 = 0.0;
+        for (int k = 0; k < width; ++k)
+        {
+            rowA[static_cast<size_t>(k)] = r0;
+            rowB[static_cast<size_t>(k)] = r1;
+
+            const double next0 = -a1 * r0 - a2 * r1;
+            r1 = r0;
+            r0 = next0;
+        }
+
+        h[0] = b0;
+        for (int k = 1; k < width; ++k)
+            h[static_cast<size_t>(k)] = rowA[static_cast<size_t>(k - 1)] * B1 + rowB[static_cast<size_t>(k - 1)] * B2;
+
+        for (int k = 0; k < width; ++k)
+        {
+            tables.stateGain1[k] = static_cast<float>(rowA[static_cast<size_t>(k)]);
+            tables.stateGain2[k] = static_cast<float>(rowB[static_cast<size_t>(k)]);
+        }
+
+        // impulse[j] lane k = h[k - j], zero above the diagonal (causality).
+        for (int j = 0; j < width; ++j)
+            for (int k = 0; k < width; ++k)
+                tables.impulse[j][k] = (k >= j) ? static_cast<float>(h[static_cast<size_t>(k - j)]) : 0.0f;
+
+        tables.width = width;
+        tablesDirty = false;
+    }
+
+    BiquadCoeffs coeffs{ 1.0, 0.0, 0.0, 0.0, 0.0 };
+    bool tablesDirty = true;
+
+    BlockTables tables;
+};
+
+#endif
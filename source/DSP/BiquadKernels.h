@@ -0,0 +1,420 @@
+#pragma once
+
+#ifndef BIQUAD3_BIQUADKERNELS_H
+#define BIQUAD3_BIQUADKERNELS_H
+
+#include <type_traits>
+#include <utility>
+#include "xsimd/include/xsimd/xsimd.hpp"
+#include "Topology.h"
+
+/*
+ * Block kernels, compiled once per instruction set and picked at startup.
+ *
+ * xsimd::batch<float> without an explicit arch is whatever the compiler flags
+ * allow, so a binary built for the SSE2 baseline runs SSE2 even on an AVX-512
+ * machine. Everything here is templated on the xsimd arch instead; the
+ * Dispatch*.cpp translation units instantiate it with -mavx2 / -mavx512f etc.
+ * and Dispatch.h picks the widest one the CPU supports (xsimd::dispatch).
+ *
+ * Two rules keep that safe:
+ *
+ * 1. The state lives in plain arrays indexed by channel (BiquadLanes),
+ *    not in batch members. A 4-lane and a 16-lane kernel see the same layout,
+ *    so the baseline per-sample code and the dispatched block code can take
+ *    turns on the same filter.
+ *
+ * 2. This header is compiled with the wide-ISA flags, so it avoids inline code
+ *    that isn't templated on the arch (std::min, std::array, ...). Such code is
+ *    emitted as a weak symbol in every TU and the linker may keep the AVX-512
+ *    copy for everyone, which faults on older CPUs. The tables the wide TUs
+ *    hand back (KernelTable, LaneKernels) are trivial types for the same
+ *    reason: they have no constructor that could be emitted. Everything a
+ *    Dispatch*.cpp object defines weakly should name its arch;
+ *    scripts/KernelSymbolCheck.py checks the built objects for that.
+ */
+
+inline constexpr int maxKernelChannels = 64;
+inline constexpr int maxKernelLanes = 16; // floats per AVX-512 register
+inline constexpr int maxCascadeBands = 16;
+
+/**
+ * One band: scalar coefficients plus the state of every channel, laid out for
+ * any structure in Topology.h (c[0..numCoeffs), s[0..numStates)). For DF2T
+ * that's c = { b0, b1, b2, a1, a2 } and s = { z1, z2 }.
+ * SampleType is float or double; the double version backs 64-bit processing.
+ */
+template <typename SampleType>
+struct alignas(64) BiquadLanes
+{
+    SampleType c[maxTopologyCoeffs] { 1 };
+    alignas(64) SampleType s[maxTopologyStates][maxKernelChannels] {};
+};
+
+/**
+ * Precomputed time-parallel tables (see BiquadBlockSIMD.h), built for `width` lanes.
+ */
+struct alignas(64) BlockTables
+{
+    int width = 0;
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    alignas(64) float stateGain1[maxKernelLanes] {};
+    alignas(64) float stateGain2[maxKernelLanes] {};
+    alignas(64) float impulse[maxKernelLanes][maxKernelLanes] {};
+};
+
+/**
+ * Skewed-pipeline lane layout (see BiquadSkewedSIMD.h), built for `width` lanes.
+ */
+struct alignas(64) SkewedLanes
+{
+    static constexpr int maxVectors = 2;
+
+    int width = 0;
+    int numBands = 0;
+    int channelsPerVector = 1;
+
+    alignas(64) float b0[maxKernelLanes] {};
+    alignas(64) float b1[maxKernelLanes] {};
+    alignas(64) float b2[maxKernelLanes] {};
+    alignas(64) float a1[maxKernelLanes] {};
+    alignas(64) float a2[maxKernelLanes] {};
+
+    alignas(64) float z1[maxVectors][maxKernelLanes] {};
+    alignas(64) float z2[maxVectors][maxKernelLanes] {};
+    alignas(64) float y[maxVectors][maxKernelLanes] {};
+};
+
+template <class Arch>
+struct BiquadKernels
+{
+    // The lane-packed kernels come in float and double; the time-parallel and
+    // skewed ones are float only.
+    template <typename SampleType>
+    using BatchOf = xsimd::batch<SampleType, Arch>;
+
+    template <typename SampleType>
+    static constexpr int lanesOf = static_cast<int>(BatchOf<SampleType>::size);
+
+    using Batch = BatchOf<float>;
+    static constexpr int lanes = lanesOf<float>;
+
+    static_assert(lanes <= maxKernelLanes, "Raise maxKernelLanes for this architecture.");
+    static_assert(lanes >= 2, "The time-parallel state update needs two samples per block.");
+
+    // One sample from each of `count` channels into a vector, unused lanes
+    // zero; and back. The baseline code (BiquadSIMD, Oversampler, Resampler)
+    // uses these too, through BiquadKernels<xsimd::default_arch>.
+    template <typename SampleType>
+    static inline BatchOf<SampleType> gather(const SampleType* const* channels, int count, int index) noexcept
+    {
+        alignas(Arch::alignment()) SampleType buf[lanesOf<SampleType>] = {};
+        for (int c = 0; c < count; ++c)
+            buf[c] = channels[c][index];
+
+        return BatchOf<SampleType>::load_aligned(buf);
+    }
+
+    template <typename SampleType>
+    static inline void scatter(const BatchOf<SampleType>& y, SampleType* const* channels, int count, int index) noexcept
+    {
+        alignas(Arch::alignment()) SampleType buf[lanesOf<SampleType>];
+        y.store_aligned(buf);
+        for (int c = 0; c < count; ++c)
+            channels[c][index] = buf[c];
+    }
+
+    template <typename Topology, typename SampleType>
+    static inline void broadcastCoeffs(const BiquadLanes<SampleType>& band, BatchOf<SampleType>* c) noexcept
+    {
+        for (int k = 0; k < Topology::numCoeffs; ++k)
+            c[k] = BatchOf<SampleType>(band.c[k]);
+    }
+
+    template <typename Topology, typename SampleType>
+    static inline void loadState(const BiquadLanes<SampleType>& band, int first, BatchOf<SampleType>* s) noexcept
+    {
+        for (int k = 0; k < Topology::numStates; ++k)
+            s[k] = BatchOf<SampleType>::load_aligned(band.s[k] + first);
+    }
+
+    template <typename Topology, typename SampleType>
+    static inline void storeState(BiquadLanes<SampleType>& band, int first, const BatchOf<SampleType>* s) noexcept
+    {
+        for (int k = 0; k < Topology::numStates; ++k)
+            s[k].store_aligned(band.s[k] + first);
+    }
+
+    /**
+     * One band, channels packed into lanes (BiquadSIMD::processBlock).
+     */
+    template <typename Topology, typename SampleType>
+    static void lanewise(BiquadLanes<SampleType>& band, SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        using B = BatchOf<SampleType>;
+        constexpr int width = lanesOf<SampleType>;
+
+        B c[Topology::numCoeffs];
+        broadcastCoeffs<Topology>(band, c);
+
+        for (int first = 0; first < numChannels; first += width)
+        {
+            const int count = (numChannels - first < width) ? numChannels - first : width;
+            SampleType* const* group = channels + first;
+
+            B s[Topology::numStates];
+            loadState<Topology>(band, first, s);
+
+            for (int i = 0; i < numSamples; ++i)
+                scatter(Topology::tick(gather(group, count, i), c, s), group, count, i);
+
+            storeState<Topology>(band, first, s);
+        }
+    }
+
+    /**
+     * NumBands bands in series, fused per frame (Cascade's steady path).
+     * The band loops have a constant trip count, so they're fully unrolled:
+     * the coefficients and state of every band are gathered once per channel
+     * group into band-indexed arrays of vectors, which stay in registers for
+     * a few bands and stream from L1 in order for more.
+     */
+    template <typename Topology, typename SampleType, int NumBands>
+    static void cascade(BiquadLanes<SampleType>* const* bands, SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        using B = BatchOf<SampleType>;
+        constexpr int width = lanesOf<SampleType>;
+
+        B c[NumBands][Topology::numCoeffs];
+        for (int b = 0; b < NumBands; ++b)
+            broadcastCoeffs<Topology>(*bands[b], c[b]);
+
+        for (int first = 0; first < numChannels; first += width)
+        {
+            const int count = (numChannels - first < width) ? numChannels - first : width;
+            SampleType* const* group = channels + first;
+
+            B s[NumBands][Topology::numStates];
+            for (int b = 0; b < NumBands; ++b)
+                loadState<Topology>(*bands[b], first, s[b]);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                B x = gather(group, count, i);
+                for (int b = 0; b < NumBands; ++b)
+                    x = Topology::tick(x, c[b], s[b]);
+
+                scatter(x, group, count, i);
+            }
+
+            for (int b = 0; b < NumBands; ++b)
+                storeState<Topology>(*bands[b], first, s[b]);
+        }
+    }
+
+    /**
+     * One DF2T band, consecutive samples of one channel per vector (BiquadBlockSIMD).
+     * `tables.width` must equal `lanes`.
+     */
+    static void timeParallel(const BlockTables& tables, BiquadLanes<float>& band,
+                             float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        const Batch stateGain1 = Batch::load_aligned(tables.stateGain1);
+        const Batch stateGain2 = Batch::load_aligned(tables.stateGain2);
+
+        Batch impulse[lanes];
+        for (int j = 0; j < lanes; ++j)
+            impulse[j] = Batch::load_aligned(tables.impulse[j]);
+
+        const float b0 = tables.b0, b1 = tables.b1, b2 = tables.b2, a1 = tables.a1, a2 = tables.a2;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = channels[ch];
+            float z1 = band.s[0][ch];
+            float z2 = band.s[1][ch];
+
+            int i = 0;
+            for (; i + lanes <= numSamples; i += lanes)
+            {
+                // The input part doesn't depend on the state, so it can run ahead
+                // of the recursion; only the last two FMAs sit on the critical path.
+                Batch acc = impulse[0] * Batch(data[i]);
+                for (int j = 1; j < lanes; ++j)
+                    acc = xsimd::fma(impulse[j], Batch(data[i + j]), acc);
+
+                const Batch y = xsimd::fma(stateGain1, Batch(z1), xsimd::fma(stateGain2, Batch(z2), acc));
+
+                const float xLast = data[i + lanes - 1];
+                const float xPrev = data[i + lanes - 2];
+                y.store_unaligned(data + i);
+                const float yLast = data[i + lanes - 1];
+                const float yPrev = data[i + lanes - 2];
+
+                z1 = (b1 * xLast - a1 * yLast) + (b2 * xPrev - a2 * yPrev);
+                z2 = b2 * xLast - a2 * yLast;
+            }
+
+            // Remainder: plain DF2T on the same state.
+            for (; i < numSamples; ++i)
+            {
+                const float x = data[i];
+                const float y = x * b0 + z1;
+                z1 = (x * b1 + z2) - (y * a1);
+                z2 = (x * b2) - (y * a2);
+                data[i] = y;
+            }
+
+            band.s[0][ch] = z1;
+            band.s[1][ch] = z2;
+        }
+    }
+
+    /**
+     * Every band of a stereo pair in one or two vectors (BiquadSkewedSIMD).
+     * `skewedLanes.width` must equal `lanes`.
+     */
+    static void skewed(SkewedLanes& skewedLanes, float* left, float* right, int numSamples) noexcept
+    {
+        if (skewedLanes.channelsPerVector == 2)
+            skewedImpl<2>(skewedLanes, left, right, numSamples);
+        else
+            skewedImpl<1>(skewedLanes, left, right, numSamples);
+    }
+
+    template <int ChannelsPerVector>
+    static void skewedImpl(SkewedLanes& s, float* left, float* right, int numSamples) noexcept
+    {
+        constexpr int numVectors = 2 / ChannelsPerVector;
+        constexpr unsigned bandStride = ChannelsPerVector * sizeof(float);
+        const int outLane = (s.numBands - 1) * ChannelsPerVector;
+
+        float* channels[2] = { left, right };
+
+        const Batch c[5] = { Batch::load_aligned(s.b0), Batch::load_aligned(s.b1), Batch::load_aligned(s.b2),
+                             Batch::load_aligned(s.a1), Batch::load_aligned(s.a2) };
+
+        // Locals so the pipeline stays in registers for the whole block.
+        Batch z[numVectors][2], y[numVectors];
+        for (int v = 0; v < numVectors; ++v)
+        {
+            z[v][0] = Batch::load_aligned(s.z1[v]);
+            z[v][1] = Batch::load_aligned(s.z2[v]);
+            y[v] = Batch::load_aligned(s.y[v]);
+        }
+
+        // Only the input lanes are rewritten per sample; the rest stay zero.
+        alignas(Arch::alignment()) float xBuf[lanes] = {};
+        alignas(Arch::alignment()) float yBuf[lanes];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int v = 0; v < numVectors; ++v)
+            {
+                for (int ch = 0; ch < ChannelsPerVector; ++ch)
+                    xBuf[ch] = channels[v * ChannelsPerVector + ch][i];
+
+                const Batch x = xsimd::slide_left<bandStride>(y[v]) + Batch::load_aligned(xBuf);
+                y[v] = DF2T::tick(x, c, z[v]);
+
+                y[v].store_aligned(yBuf);
+                for (int ch = 0; ch < ChannelsPerVector; ++ch)
+                    channels[v * ChannelsPerVector + ch][i] = yBuf[outLane + ch];
+            }
+        }
+
+        for (int v = 0; v < numVectors; ++v)
+        {
+            z[v][0].store_aligned(s.z1[v]);
+            z[v][1].store_aligned(s.z2[v]);
+            y[v].store_aligned(s.y[v]);
+        }
+    }
+};
+
+/**
+ * Lane-packed entry points for one sample type.
+ */
+template <typename SampleType>
+struct LaneKernels
+{
+    using LanewiseFn = void (*)(BiquadLanes<SampleType>&, SampleType* const*, int, int) noexcept;
+    using CascadeFn = void (*)(BiquadLanes<SampleType>* const*, SampleType* const*, int, int) noexcept;
+
+    // No default member initialisers: see rule 2 at the top. Value-initialise instead.
+    LanewiseFn lanewise;
+    CascadeFn cascade[maxCascadeBands]; // cascade[n - 1] runs n bands
+};
+
+/**
+ * Entry points of one instantiation of BiquadKernels.
+ */
+struct KernelTable
+{
+    using TimeParallelFn = void (*)(const BlockTables&, BiquadLanes<float>&, float* const*, int, int) noexcept;
+    using SkewedFn = void (*)(SkewedLanes&, float*, float*, int) noexcept;
+
+    // No default member initialisers, as in LaneKernels.
+    const char* name;
+    int lanes; // floats per vector
+
+    // Indexed by Topology::id.
+    LaneKernels<float> f32[numTopologies];
+    LaneKernels<double> f64[numTopologies];
+    TimeParallelFn timeParallel; // DF2T only
+    SkewedFn skewed;             // DF2T only
+
+    template <typename SampleType, typename Topology = DF2T>
+    const LaneKernels<SampleType>& get() const noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return f64[Topology::id];
+        else
+            return f32[Topology::id];
+    }
+};
+
+static_assert(std::is_trivially_default_constructible_v<KernelTable>
+              && std::is_trivially_copyable_v<KernelTable>,
+              "KernelTable is built in the wide-ISA translation units; see rule 2 at the top.");
+
+/**
+ * xsimd::dispatch functor: called with the best available arch tag, returns
+ * that arch's kernels. Explicitly instantiated in the Dispatch*.cpp files.
+ */
+struct KernelSelector
+{
+    template <class Arch>
+    KernelTable operator()(Arch) const
+    {
+        using K = BiquadKernels<Arch>;
+
+        KernelTable table {};
+        table.name = Arch::name();
+        table.lanes = K::lanes;
+        fill<K, DF2T>(table);
+        fill<K, DF1>(table);
+        fill<K, TPTSVF>(table);
+        fill<K, Lattice>(table);
+        table.timeParallel = &K::timeParallel;
+        table.skewed = &K::skewed;
+        return table;
+    }
+
+    template <class K, typename Topology>
+    static void fill(KernelTable& table)
+    {
+        fillLanes<K, Topology>(table.f32[Topology::id], std::make_index_sequence<maxCascadeBands> {});
+        fillLanes<K, Topology>(table.f64[Topology::id], std::make_index_sequence<maxCascadeBands> {});
+    }
+
+    // One fully unrolled cascade per band count.
+    template <class K, typename Topology, typename SampleType, std::size_t... Index>
+    static void fillLanes(LaneKernels<SampleType>& kernels, std::index_sequence<Index...>)
+    {
+        kernels.lanewise = &K::template lanewise<Topology, SampleType>;
+        ((kernels.cascade[Index] = &K::template cascade<Topology, SampleType, static_cast<int>(Index) + 1>), ...);
+    }
+};
+
+#endif
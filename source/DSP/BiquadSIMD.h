@@ -3,78 +3,320 @@
 #ifndef BIQUAD3_BIQUADSIMD_H
 #define BIQUAD3_BIQUADSIMD_H
 
+#include <algorithm>
 #include <array>
 #include "xsimd/include/xsimd/xsimd.hpp"
+#include "BiquadKernels.h"
+#include "Dispatch.h"
 #include "Qcalc.h"
+#include "Topology.h"
 
 /*
- * Stereo biquad using SIMD across channels (L/R in lanes 0/1).
- * Filter structure: Direct Form II Transposed.
+ * Multichannel biquad using SIMD across channels.
+ * Filter structure: any policy from Topology.h, Direct Form II Transposed by default.
+ *
+ * Channels are packed into the lane width: channel c lives in lane c % lanes
+ * of vector c / lanes, so a 7.1.4 bus is two SSE vectors or one AVX vector plus
+ * a half-empty one, and 16 channels fill one AVX-512 vector. Mono gets a scalar
+ * kernel, since a vector with one live lane is just a slower float.
+ *
+ * The coefficients and state are stored as plain values (BiquadLanes),
+ * one slot per channel. processBlock() hands them to the dispatched kernel for
+ * the host CPU (see Dispatch.h); processFrame() and the Coeffs/State helpers
+ * use the baseline xsimd::batch for the per-sample paths that run while
+ * parameters are smoothing. Both read and write the same slots.
+ *
+ * Coefficient ramps: startRamp() moves the coefficients in a straight line to
+ * a new set over a number of samples. processRamp() runs that in SIMD, with
+ * the coefficients for sample j computed as start + (j + 1) * increment, so
+ * nothing accumulates. stepRamp() is the per-sample equivalent for the
+ * callers that interleave bands. Engine uses this to recompute the
+ * coefficients only every few samples while smoothing.
+ *
+ * SampleType is float or double. Qcalc designs in double, so the double
+ * version keeps the full coefficient precision that low shelves at high
+ * sample rates need; a vector then holds half as many channels.
  */
-class alignas(16) BiquadSIMD {
+template <typename SampleType, typename Topology = DF2T>
+class alignas(64) BiquadSIMD {
 public:
-    BiquadSIMD() { reset(); }
+    using Batch = xsimd::batch<SampleType>;
+    using Kernels = BiquadKernels<xsimd::default_arch>;
+    using TopologyType = Topology;
+    using Params = typename Topology::Params;
+
+    static constexpr int maxChannels = maxKernelChannels;
+    static constexpr int lanes = static_cast<int>(Batch::size);
+    static constexpr int maxVectors = (maxChannels + lanes - 1) / lanes;
+    static constexpr int numCoeffs = Topology::numCoeffs;
+    static constexpr int numStates = Topology::numStates;
+
+    struct Coeffs { Batch c[numCoeffs] {}; };
+    struct State  { Batch s[numStates] {}; };
+
+    BiquadSIMD()
+    {
+        setCoeffs({ 1.0, 0.0, 0.0, 0.0, 0.0 });
+        reset();
+    }
 
     void reset() noexcept
     {
-        z1 = Batch(0.0f);
-        z2 = Batch(0.0f);
+        for (auto& state : data.s)
+            std::fill(std::begin(state), std::end(state), SampleType(0));
+    }
+
+    /**
+     * Load a digital biquad, converted to this structure.
+     */
+    void setCoeffs(const BiquadCoeffs& c) noexcept
+    {
+        setParams(Topology::fromBiquad(c));
+    }
+
+    /**
+     * Load coefficients already in this structure's parametrisation
+     * (e.g. TPTSVF::fromPrototype). Cancels a running ramp.
+     */
+    void setParams(const Params& p) noexcept
+    {
+        ramp.length = ramp.position = 0;
+        loadParams(p);
+    }
+
+    // The coefficients currently loaded, in double.
+    const Params& getParams() const noexcept { return params; }
+
+    /**
+     * Ramp linearly from the current coefficients to `target` over `length`
+     * samples; the last sample of the ramp runs exactly on `target`.
+     * The caller is responsible for the ramp staying stable (see Engine).
+     */
+    void startRamp(const Params& target, int length) noexcept
+    {
+        ramp.start = params;
+        ramp.target = target;
+        ramp.length = std::max(length, 1);
+        ramp.position = 0;
+
+        const double scale = 1.0 / ramp.length;
+        for (auto k{0uz}; k < params.size(); ++k)
+            ramp.increment[k] = (target[k] - ramp.start[k]) * scale;
+    }
+
+    bool isRamping() const noexcept { return ramp.position < ramp.length; }
+
+    // Jump to the end of a running ramp.
+    void finishRamp() noexcept
+    {
+        if (isRamping())
+            setParams(ramp.target);
+    }
+    int getRampRemaining() const noexcept { return ramp.length - ramp.position; }
+
+    // The coefficients `step` samples into the current ramp.
+    Params getRampPoint(int step) const noexcept
+    {
+        if (step >= ramp.length)
+            return ramp.target;
+
+        Params p;
+        for (auto k{0uz}; k < p.size(); ++k)
+            p[k] = ramp.start[k] + ramp.increment[k] * step;
+
+        return p;
     }
 
-    void setCoeffs(const BiquadCoeffs& coeffs) noexcept
+    /**
+     * Advance the ramp by one sample (per-sample paths).
+     * @return false if no ramp was running
+     */
+    bool stepRamp() noexcept
     {
-        b0_vec = Batch(static_cast<float>(coeffs.b0));
-        b1_vec = Batch(static_cast<float>(coeffs.b1));
-        b2_vec = Batch(static_cast<float>(coeffs.b2));
-        a1_vec = Batch(static_cast<float>(coeffs.a1));
-        a2_vec = Batch(static_cast<float>(coeffs.a2));
+        if (! isRamping())
+            return false;
+
+        loadParams(getRampPoint(++ramp.position));
+        return true;
     }
 
-    inline void processStereo(const float* leftIn,
-                              const float* rightIn,
-                              float* leftOut,
-                              float* rightOut) noexcept
+    // Baseline-width broadcast of the coefficients, for the per-sample paths.
+    Coeffs getCoeffs() const noexcept
     {
-        std::array<float, Batch::size> xBuf{};
-        xBuf[0] = *leftIn;
-        xBuf[1] = *rightIn;
-        const Batch x = Batch::load_unaligned(xBuf.data());
+        Coeffs c;
+        for (int k = 0; k < numCoeffs; ++k)
+            c.c[k] = Batch(data.c[k]);
 
-        const Batch y = x * b0_vec + z1;
-        const Batch newZ1 = (x * b1_vec + z2) - (y * a1_vec);
-        const Batch newZ2 = (x * b2_vec) - (y * a2_vec);
+        return c;
+    }
+
+    // State of channels [vector * lanes, (vector + 1) * lanes).
+    State loadState(int vector) const noexcept
+    {
+        const int first = vector * lanes;
 
-        z1 = newZ1;
-        z2 = newZ2;
+        State st;
+        for (int k = 0; k < numStates; ++k)
+            st.s[k] = Batch::load_aligned(data.s[k] + first);
 
-        std::array<float, Batch::size> yBuf{};
-        y.store_unaligned(yBuf.data());
-        *leftOut = yBuf[0];
-        *rightOut = yBuf[1];
+        return st;
     }
 
-    void processBlock(float* const* channelData, int numSamples) noexcept
+    void storeState(int vector, const State& st) noexcept
     {
-        if (channelData == nullptr || numSamples <= 0) {
+        const int first = vector * lanes;
+        for (int k = 0; k < numStates; ++k)
+            st.s[k].store_aligned(data.s[k] + first);
+    }
+
+    // The raw storage, for the dispatched kernels.
+    BiquadLanes<SampleType>& getLanes() noexcept { return data; }
+
+    // One step of the structure for every lane.
+    static inline Batch tick(const Batch& x, const Coeffs& c, State& s) noexcept
+    {
+        return Topology::tick(x, c.c, s.s);
+    }
+
+    /**
+     * Process sample `index` of every channel. Used while coefficients change per sample.
+     */
+    inline void processFrame(SampleType* const* channelData, int numChannels, int index) noexcept
+    {
+        const Coeffs c = getCoeffs();
+
+        numChannels = std::min(numChannels, maxChannels);
+        for (int first = 0, v = 0; first < numChannels; first += lanes, ++v)
+        {
+            const int count = std::min(lanes, numChannels - first);
+
+            State s = loadState(v);
+            Kernels::scatter(tick(Kernels::gather(channelData + first, count, index), c, s), channelData + first, count, index);
+            storeState(v, s);
+        }
+    }
+
+    void processBlock(SampleType* const* channelData, int numChannels, int numSamples) noexcept
+    {
+        if (channelData == nullptr || numSamples <= 0 || numChannels <= 0) {
             return;
         }
 
-        float* L = channelData[0];
-        float* R = channelData[1];
-        if (L == nullptr || R == nullptr) {
+        if (numChannels == 1) {
+            processMono(channelData[0], numSamples);
             return;
         }
 
-        for (int i = 0; i < numSamples; ++i) {
-            processStereo(&L[i], &R[i], &L[i], &R[i]);
+        Dispatch::getKernels().get<SampleType, Topology>().lanewise(data, channelData, std::min(numChannels, maxChannels), numSamples);
+    }
+
+    /**
+     * Process samples [start, start + numSamples) of every channel while the
+     * coefficients ramp, numSamples <= getRampRemaining(). The ramp advances by
+     * numSamples.
+     */
+    void processRamp(SampleType* const* channelData, int numChannels, int start, int numSamples) noexcept
+    {
+        numSamples = std::min(numSamples, getRampRemaining());
+        if (channelData == nullptr || numSamples <= 0 || numChannels <= 0)
+            return;
+
+        Batch base[numCoeffs], increment[numCoeffs];
+        for (int k = 0; k < numCoeffs; ++k)
+        {
+            base[k] = Batch(static_cast<SampleType>(ramp.start[static_cast<size_t>(k)]));
+            increment[k] = Batch(static_cast<SampleType>(ramp.increment[static_cast<size_t>(k)]));
         }
+
+        numChannels = std::min(numChannels, maxChannels);
+        for (int first = 0, v = 0; first < numChannels; first += lanes, ++v)
+        {
+            const int count = std::min(lanes, numChannels - first);
+            SampleType* const* group = channelData + first;
+
+            State s = loadState(v);
+            Coeffs c;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const Batch step(static_cast<SampleType>(ramp.position + i + 1));
+                for (int k = 0; k < numCoeffs; ++k)
+                    c.c[k] = xsimd::fma(step, increment[k], base[k]);
+
+                Kernels::scatter(tick(Kernels::gather(group, count, start + i), c, s), group, count, start + i);
+            }
+            storeState(v, s);
+        }
+
+        ramp.position += numSamples;
+        loadParams(getRampPoint(ramp.position));
+    }
+
+    /**
+     * Dedicated mono kernel: the scalar structure on channel 0's state.
+     */
+    void processMono(SampleType* samples, int numSamples) noexcept
+    {
+        std::array<SampleType, numCoeffs> c;
+        getScalarCoeffs(c);
+
+        std::array<SampleType, numStates> s;
+        getScalarState(s);
+
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = Topology::tick(samples[i], c.data(), s.data());
+
+        setScalarState(s);
+    }
+
+    // The structure's coefficients, e.g. { b0, b1, b2, a1, a2 } for DF2T.
+    void getScalarCoeffs(std::array<SampleType, numCoeffs>& out) const noexcept
+    {
+        std::copy(data.c, data.c + numCoeffs, out.begin());
+    }
+
+    // Channel 0's state, for the scalar mono paths.
+    void getScalarState(std::array<SampleType, numStates>& out) const noexcept
+    {
+        for (int k = 0; k < numStates; ++k)
+            out[static_cast<size_t>(k)] = data.s[k][0];
+    }
+
+    void setScalarState(const std::array<SampleType, numStates>& in) noexcept
+    {
+        for (int k = 0; k < numStates; ++k)
+            data.s[k][0] = in[static_cast<size_t>(k)];
+    }
+
+    // True if every state value of every channel is smaller than `threshold`
+    // in magnitude (false on NaN).
+    bool isStateBelow(SampleType threshold) const noexcept
+    {
+        bool below = true;
+        for (int k = 0; k < numStates; ++k)
+            for (int ch = 0; ch < maxChannels; ++ch)
+                below &= std::abs(data.s[k][ch]) < threshold;
+
+        return below;
     }
 
 private:
-    using Batch = xsimd::batch<float>;
+    struct Ramp
+    {
+        Params start {}, increment {}, target {};
+        int length = 0;
+        int position = 0;
+    };
+
+    void loadParams(const Params& p) noexcept
+    {
+        params = p;
+        for (int k = 0; k < numCoeffs; ++k)
+            data.c[k] = static_cast<SampleType>(p[static_cast<size_t>(k)]);
+    }
 
-    Batch b0_vec{}, b1_vec{}, b2_vec{}, a1_vec{}, a2_vec{};
-    Batch z1{}, z2{};
+    BiquadLanes<SampleType> data;
+    Params params {};
+    Ramp ramp;
 };
 
 #endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#ifndef BIQUAD3_BIQUADSKEWEDSIMD_H
+#define BIQUAD3_BIQUADSKEWEDSIMD_H
+
+#include <algorithm>
+#include "Dispatch.h"
+#include "Qcalc.h"
+
+/*
+ * Skewed-pipeline stereo cascade: every band of every channel in one vector.
+ *
+ * The bands are strictly serial, so sample n can't enter band k+1 until band k is
+ * done with it. Skewing time fixes that: band k works on sample n - k, so in any
+ * one step the bands are all busy with different samples and none of them waits
+ * on another. The DF2T update from BiquadSIMD then advances the whole EQ by one
+ * sample with a single set of vector ops. The kernel itself is
+ * BiquadKernels::skewed, built per instruction set (see Dispatch.h).
+ *
+ * Lane layout for 3 bands, channelsPerVector = 2 (AVX, AVX-512):
+ *
+ *     [ HS.L  HS.R  MP.L  MP.R  LS.L  LS.R  -  - ]          one vector
+ *
+ * and channelsPerVector = 1 when the vector is too narrow (SSE, NEON):
+ *
+ *     [ HS  MP  LS  - ]  left      [ HS  MP  LS  - ]  right
+ *
+ * Each step slides last step's outputs up by one band (band k's output becomes band
+ * k+1's input), drops the new input into the bottom lanes and runs one DF2T tick.
+ * The last band's lanes then hold the output for sample n - (numBands - 1), which
+ * is the latency this adds; Cascade reports it through getLatencySamples().
+ *
+ * Unused lanes get all-zero coefficients, so they stay at zero. The number of
+ * bands that fit is set by the active lane count; check isSupported().
+ */
+class BiquadSkewedSIMD {
+public:
+    BiquadSkewedSIMD()
+    {
+        setNumBands(3);
+    }
+
+    /**
+     * Lay the lanes out for `count` bands. Clears the coefficients and state.
+     */
+    void setNumBands(int count) noexcept
+    {
+        // The lane layout depends on the vector width of the dispatched kernels.
+        const int width = Dispatch::getActiveLaneCount();
+        lanes.width = width;
+        lanes.numBands = count;
+        lanes.channelsPerVector = (width >= count * 2) ? 2 : 1;
+
+        for (auto* c : { lanes.b0, lanes.b1, lanes.b2, lanes.a1, lanes.a2 })
+            std::fill(c, c + maxKernelLanes, 0.0f);
+
+        reset();
+    }
+
+    int getNumBands() const noexcept { return lanes.numBands; }
+
+    /**
+     * The delay the pipeline adds: one sample per band after the first.
+     */
+    int getLatencySamples() const noexcept { return lanes.numBands - 1; }
+
+    /**
+     * True if one vector of the active kernel set can hold `count` bands of a channel.
+     */
+    static bool isSupported(int count) noexcept
+    {
+        return Dispatch::getActiveLaneCount() >= count;
+    }
+
+    void reset() noexcept
+    {
+        for (int v = 0; v < SkewedLanes::maxVectors; ++v)
+        {
+            std::fill(std::begin(lanes.z1[v]), std::end(lanes.z1[v]), 0.0f);
+            std::fill(std::begin(lanes.z2[v]), std::end(lanes.z2[v]), 0.0f);
+            std::fill(std::begin(lanes.y[v]), std::end(lanes.y[v]), 0.0f);
+        }
+    }
+
+    /**
+     * Set the coefficients of one band for both channels.
+     */
+    void setBandCoeffs(size_t band, const BiquadCoeffs& c) noexcept
+    {
+        const auto channelsPerVector = static_cast<size_t>(lanes.channelsPerVector);
+        for (auto ch{0uz}; ch < channelsPerVector; ++ch)
+        {
+            const size_t lane = band * channelsPerVector + ch;
+            lanes.b0[lane] = static_cast<float>(c.b0);
+            lanes.b1[lane] = static_cast<float>(c.b1);
+            lanes.b2[lane] = static_cast<float>(c.b2);
+            lanes.a1[lane] = static_cast<float>(c.a1);
+            lanes.a2[lane] = static_cast<float>(c.a2);
+        }
+    }
+
+    void processBlock(float* leftChannel, float* rightChannel, int numSamples) noexcept
+    {
+        Dispatch::getKernels().skewed(lanes, leftChannel, rightChannel, numSamples);
+    }
+
+private:
+    SkewedLanes lanes;
+};
+
+#endif
@@ -0,0 +1,310 @@
+#pragma once
+
+#ifndef BIQUAD3_BYPASSFADE_H
+#define BIQUAD3_BYPASSFADE_H
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Crossfade between the processed (wet) and unprocessed (dry) signal when
+ * bypass is toggled.
+ *
+ * While fully active the wet path runs on the buffer as before; while fully
+ * bypassed nothing runs and the dry signal is simply left in place. Only
+ * during the fade is a dry copy kept and mixed back in, as a linear
+ * (equal-gain) ramp: wet and dry are the same signal bar the EQ, so an
+ * equal-power fade would bump the level halfway through.
+ *
+ * Warm restart: while bypassed the last prerollTimeMs of input are kept
+ * in a ring (one copy per block). When bypass is released the wet path
+ * first runs over that history, output discarded, so the filters start
+ * the fade in settled on the signal instead of ringing up from rest.
+ * The catch-up is spread over the blocks after the release: each block
+ * runs at most its own length of history on top of its own samples, and
+ * stays dry until the wet path has caught up with the input. So a release
+ * costs at most twice a normal block, whatever the block size, and the
+ * fade starts up to prerollTimeMs later.
+ *
+ * Latency: if the wet path delays its output (oversampling), setLatency()
+ * delays the dry path by the same amount, so the two line up in the fade and
+ * the bypassed output keeps the latency the host compensates for. The delay
+ * line is fed every block, active or not; with no latency it isn't touched.
+ */
+template <typename SampleType>
+class BypassFade {
+public:
+    static constexpr double defaultFadeTimeMs = 10.0;
+    static constexpr double defaultPrerollTimeMs = 10.0;
+
+    BypassFade() = default;
+
+    /**
+     * Allocate the dry copy and the history, and set the fade length.
+     * Call from prepareToPlay().
+     *
+     * @param sampleRate The sample rate in Hz
+     * @param samplesPerBlock Maximum expected block size
+     * @param numChannels Channel count of the bus
+     * @param fadeTimeMs Length of the crossfade in milliseconds
+     * @param prerollTimeMs Input history run through the wet path on release (0 = none)
+     */
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels,
+                 double fadeTimeMs = defaultFadeTimeMs, double prerollTimeMs = defaultPrerollTimeMs)
+    {
+        dry.setSize(numChannels, samplesPerBlock);
+        mix.reset(sampleRate, fadeTimeMs / 1000.0);
+
+        history.setSize(numChannels, static_cast<int>(std::ceil(sampleRate * prerollTimeMs / 1000.0)));
+        history.clear();
+        historyWrite = 0;
+        historyLength = 0;
+        resumed = true;
+    }
+
+    /**
+     * Allocate the dry delay for up to maxLatencySamples. Call from
+     * prepareToPlay(), after prepare().
+     */
+    void prepareLatency(int maxLatencySamples)
+    {
+        delay.setSize(std::max(dry.getNumChannels(), 1), std::max(maxLatencySamples, 1));
+        setLatency(0);
+    }
+
+    /**
+     * Delay the dry path by `samples` (clamped to the prepared maximum) and
+     * clear it. Allocation-free.
+     */
+    void setLatency(int samples)
+    {
+        latency = std::clamp(samples, 0, delay.getNumSamples());
+        delay.clear();
+        delayPosition = 0;
+    }
+
+    int getLatency() const { return latency; }
+
+    /**
+     * Start fading towards bypassed or active. Cheap; call every block.
+     */
+    void setBypassed(bool shouldBeBypassed)
+    {
+        mix.setTargetValue(shouldBeBypassed ? SampleType(0) : SampleType(1));
+    }
+
+    /**
+     * Jump to the current target, e.g. after prepare().
+     */
+    void finishFade()
+    {
+        mix.setCurrentAndTargetValue(mix.getTargetValue());
+    }
+
+    /**
+     * Bypassed with the fade finished: the wet path needn't run at all.
+     */
+    bool isBypassed() const
+    {
+        return ! mix.isSmoothing() && mix.getTargetValue() == SampleType(0);
+    }
+
+    bool isFading() const { return mix.isSmoothing(); }
+
+    /**
+     * Run `wetPath` on the channels in place and, during a fade, mix the
+     * input back in. While isBypassed() this only records the input for
+     * the warm restart; the wet path must be reset by then (it resumes
+     * from the history).
+     *
+     * Takes raw channel pointers, like Engine::processBlock, so callers can
+     * pass part of a buffer: a juce::AudioBuffer view of more than 31
+     * channels would allocate its pointer table.
+     *
+     * @param channels Array of channel pointers, processed in place
+     * @param numChannels Number of channels
+     * @param numSamples Number of samples
+     * @param wetPath Callable taking (SampleType* const* channels, int numChannels,
+     *                int numSamples), e.g. Cascade::processBlock
+     */
+    template <typename WetPath>
+    void process(SampleType* const* channels, int numChannels, int numSamples, WetPath&& wetPath)
+    {
+        if (isBypassed())
+        {
+            record(channels, numChannels, numSamples);
+            delayDry(channels, numChannels, numSamples, true);
+            resumed = false;
+            return;
+        }
+
+        if (! resumed && ! preroll(channels, numChannels, numSamples, wetPath))
+        {
+            // Still catching up: dry, as while bypassed, and the fade waits.
+            delayDry(channels, numChannels, numSamples, true);
+            return;
+        }
+
+        if (! mix.isSmoothing())
+        {
+            delayDry(channels, numChannels, numSamples, false);
+            wetPath(channels, numChannels, numSamples);
+            return;
+        }
+
+        // Only reallocates if the host goes over the prepared block size.
+        dry.setSize(std::max(numChannels, dry.getNumChannels()), std::max(numSamples, dry.getNumSamples()),
+                    false, false, true);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            dry.copyFrom(ch, 0, channels[ch], numSamples);
+
+        delayDry(dry.getArrayOfWritePointers(), numChannels, numSamples, true);
+
+        wetPath(channels, numChannels, numSamples);
+
+        // Wet ramps from startGain to endGain, dry the opposite way, in one pass.
+        const SampleType startGain = mix.getCurrentValue();
+        const SampleType endGain = mix.skip(numSamples);
+        const SampleType increment = (endGain - startGain) / static_cast<SampleType>(numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            SampleType* wet = channels[ch];
+            const SampleType* dryCopy = dry.getReadPointer(ch);
+            SampleType gain = startGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                wet[i] = wet[i] * gain + dryCopy[i] * (SampleType(1) - gain);
+                gain += increment;
+            }
+        }
+    }
+
+private:
+    // Keep the last history.getNumSamples() samples of input.
+    void record(const SampleType* const* channels, int numChannels, int numSamples)
+    {
+        const int capacity = history.getNumSamples();
+        const int offset = numSamples - std::min(numSamples, capacity);
+        numChannels = std::min(numChannels, history.getNumChannels());
+        numSamples = std::min(numSamples, capacity);
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int length = std::min(numSamples - done, capacity - historyWrite);
+            for (int ch = 0; ch < numChannels; ++ch)
+                history.copyFrom(ch, historyWrite, channels[ch] + offset + done, length);
+
+            done += length;
+            historyWrite = (historyWrite + length) % capacity;
+        }
+
+        historyLength = std::min(historyLength + numSamples, capacity);
+    }
+
+    // Push the block through the dry delay line: in place if `replace`
+    // (the output is the input from `latency` samples ago), otherwise the
+    // line is only fed.
+    void delayDry(SampleType* const* channels, int numChannels, int numSamples, bool replace)
+    {
+        if (latency == 0)
+            return;
+
+        numChannels = std::min(numChannels, delay.getNumChannels());
+        const int offset = replace ? 0 : std::max(numSamples - latency, 0);
+
+        // Skipped samples would be overwritten anyway; the position still moves past them.
+        int position = (delayPosition + offset) % latency;
+        for (int done = offset; done < numSamples;)
+        {
+            const int length = std::min(numSamples - done, latency - position);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                SampleType* samples = channels[ch] + done;
+                SampleType* line = delay.getWritePointer(ch) + position;
+                if (replace)
+                    std::swap_ranges(samples, samples + length, line);
+                else
+                    std::copy(samples, samples + length, line);
+            }
+
+            done += length;
+            position = (position + length) % latency;
+        }
+
+        delayPosition = position;
+    }
+
+    // Run the wet path over up to `budget` samples of the history not yet
+    // run, oldest first, in the dry buffer's block-sized pieces; the output
+    // is thrown away.
+    template <typename WetPath>
+    void runHistory(int budget, WetPath& wetPath)
+    {
+        const int capacity = history.getNumSamples();
+        const int numChannels = history.getNumChannels();
+        const int blockSize = dry.getNumSamples();
+        if (historyLength == 0 || blockSize == 0)
+        {
+            historyLength = 0;
+            return;
+        }
+
+        int read = (historyWrite - historyLength + capacity) % capacity;
+        for (int remaining = std::min(historyLength, budget); remaining > 0;)
+        {
+            const int length = std::min({ remaining, blockSize, capacity - read });
+
+            // The start of dry, cut to this piece's length.
+            for (int ch = 0; ch < numChannels; ++ch)
+                dry.copyFrom(ch, 0, history, ch, read, length);
+
+            wetPath(dry.getArrayOfWritePointers(), numChannels, length);
+
+            remaining -= length;
+            historyLength -= length;
+            read = (read + length) % capacity;
+        }
+    }
+
+    // One block's share of the warm restart: run a block's worth of the
+    // history; if that was the last of it, the wet path has caught up and
+    // takes this block live. Otherwise the block joins the history and a
+    // second block's worth runs, so the backlog shrinks by a block each time.
+    // @return true once caught up
+    template <typename WetPath>
+    bool preroll(const SampleType* const* channels, int numChannels, int numSamples, WetPath& wetPath)
+    {
+        runHistory(numSamples, wetPath);
+        if (historyLength == 0)
+        {
+            resumed = true;
+            return true;
+        }
+
+        record(channels, numChannels, numSamples);
+        runHistory(numSamples, wetPath);
+        return false;
+    }
+
+    // 1 = wet, 0 = dry
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> mix { SampleType(1) };
+
+    juce::AudioBuffer<SampleType> dry;
+
+    // Input ring for the warm restart. historyLength is how much of the
+    // newest input the wet path hasn't run yet; resumed once it has all run.
+    juce::AudioBuffer<SampleType> history;
+    int historyWrite = 0;
+    int historyLength = 0;
+    bool resumed = true;
+
+    // Dry delay matching the wet path's latency
+    juce::AudioBuffer<SampleType> delay;
+    int latency = 0;
+    int delayPosition = 0;
+};
+
+#endif
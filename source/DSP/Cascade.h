@@ -0,0 +1,510 @@
+#pragma once
+
+#ifndef BIQUAD3_CASCADE_H
+#define BIQUAD3_CASCADE_H
+
+#include <JuceHeader.h>
+#include <array>
+#include <span>
+#include <type_traits>
+#include "Engine.h"
+#include "BiquadSkewedSIMD.h"
+
+/**
+ * Processing strategy for the band chain.
+ */
+enum class CascadeMode
+{
+    PerBand, // one full-buffer pass per Engine (the original loop)
+    Fused,   // one pass, every band applied per sample
+    Skewed   // one pass, every band of both channels in one vector (adds latency)
+};
+
+/**
+ * The serial band chain: getNumBands() bands (1 to maxBands) of any
+ * FilterType, in index order. The plugin's default is three:
+ * HighShelf -> MidPeak -> LowShelf.
+ *
+ * Running each Engine over the whole buffer means every sample is loaded and
+ * stored once per band. At 2048-4096 sample blocks that's a trip through
+ * memory per band for what is ~15 flops per sample per band. The fused kernel
+ * loads a frame (one vector of channels) once, runs it through every DF2T
+ * section while the delay-line vectors sit in locals, and stores it once.
+ * There's a kernel per band count, each with the band loop fully unrolled;
+ * the chain picks the one for the bands that aren't skipped.
+ * Channels are packed into the lane width as in BiquadSIMD; a mono bus gets a
+ * scalar version of the same loop. The steady loop is BiquadKernels::cascade,
+ * run at the host CPU's widest instruction set (Dispatch.h).
+ *
+ * Smoothing is unchanged: each band still advances its own Engine smoothers
+ * per sample and recalculates coefficients under the same thresholds.
+ *
+ * The skewed mode packs all bands into lanes instead (see BiquadSkewedSIMD.h)
+ * and delays the output by numBands - 1 samples; read getLatencySamples() after
+ * setMode(). It's stereo only; other layouts run the fused kernel. Its state is
+ * separate from the Engines', so switching to or from it restarts the filters.
+ * It's meant for A/B runs, not live toggling.
+ * Skewed and TimeParallel are float DF2T only; other instantiations run them
+ * as Fused and Lanewise.
+ * While a band is smoothing its new coefficients reach the lanes at sample n,
+ * where that band is working on sample n - band: a 1-2 sample skew in the
+ * glide that is inaudible next to a 20 ms ramp.
+ *
+ * Topology picks the filter structure of every band (Topology.h); the fused
+ * kernels are the same loops with that structure's tick inlined.
+ *
+ * Skip paths (see Engine::skipIfIdentity()): a block of digital silence
+ * (or a buffer flagged as cleared) with every band steady and decayed skips
+ * the whole chain; otherwise bands parked at unity are left out of the
+ * fused, mono and tiled loops. The skewed mode keeps its own state and
+ * always runs in full.
+ */
+template <typename SampleType, typename Topology = DF2T>
+class Cascade {
+public:
+    static constexpr int maxBands = maxCascadeBands;
+    static constexpr int defaultNumBands = 3;
+
+    Cascade() = default;
+
+    /**
+     * Prepare every band for playback.
+     *
+     * @param sampleRate The sample rate in Hz
+     * @param samplesPerBlock Maximum expected block size
+     * @param numChannels Channel count of the bus (1 to BiquadSIMD::maxChannels)
+     */
+    void prepare(double sampleRate, int samplesPerBlock, int numChannels = 2)
+    {
+        preparedChannels = numChannels;
+
+        for (auto& band : bands)
+            band.prepare(sampleRate, samplesPerBlock);
+
+        skewed.reset();
+    }
+
+    /**
+     * Reset the delay lines of every band.
+     */
+    void reset()
+    {
+        for (auto& band : bands)
+            band.reset();
+
+        skewed.reset();
+    }
+
+    /**
+     * Band access for parameter updates, 0 to maxBands - 1. Bands past
+     * getNumBands() keep their settings but aren't run.
+     */
+    Engine<SampleType, Topology>& getBand(int index) { return bands[static_cast<size_t>(index)]; }
+
+    /**
+     * Run the first `count` bands (clamped to 1..maxBands). Bands that come
+     * back into the chain start from silence; the skewed pipeline restarts.
+     * Call between blocks, and read getLatencySamples() after it.
+     */
+    void setNumBands(int count)
+    {
+        count = std::clamp(count, 1, maxBands);
+        if (count == numBands)
+            return;
+
+        for (int b = numBands; b < count; ++b)
+            bands[static_cast<size_t>(b)].reset();
+
+        numBands = count;
+        skewed.setNumBands(count);
+    }
+
+    int getNumBands() const { return numBands; }
+
+    void setMode(CascadeMode newMode)
+    {
+        if (newMode != mode)
+            reset();
+
+        mode = newMode;
+    }
+
+    CascadeMode getMode() const { return mode; }
+
+    /**
+     * Blocks seen and whole-chain silence skips. Unity bands are counted per
+     * band: getBand(i).getFastPathCounters().
+     */
+    const FastPathCounters& getFastPathCounters() const { return counters; }
+
+    void resetFastPathCounters()
+    {
+        counters.reset();
+        for (auto& band : bands)
+            band.resetFastPathCounters();
+    }
+
+    /**
+     * Skip paths on or off for the chain and every band
+     * (see Engine::setFastPathsEnabled).
+     */
+    void setFastPathsEnabled(bool enabled)
+    {
+        fastPathsEnabled = enabled;
+        for (auto& band : bands)
+            band.setFastPathsEnabled(enabled);
+    }
+
+    /**
+     * Delay added by the current mode, to be reported to the host.
+     */
+    int getLatencySamples() const
+    {
+        return usesSkewed() ? skewed.getLatencySamples() : 0;
+    }
+
+    /**
+     * Select the steady-state kernel for every band.
+     */
+    void setKernel(BiquadKernel newKernel)
+    {
+        for (auto& band : bands)
+            band.setKernel(newKernel);
+    }
+
+    /**
+     * Coefficient update interval while smoothing, for every band
+     * (see Engine::setControlInterval).
+     */
+    void setControlInterval(int numSamples)
+    {
+        for (auto& band : bands)
+            band.setControlInterval(numSamples);
+    }
+
+    /**
+     * Precomputed design table for every band (see Engine::setCoefficientTable).
+     */
+    void setCoefficientTable(const std::shared_ptr<const CoeffTable>& table)
+    {
+        for (auto& band : bands)
+            band.setCoefficientTable(table);
+    }
+
+    /**
+     * Libm or polynomial coefficient design for every band (see Engine::setDesignMath).
+     */
+    void setDesignMath(DesignMath math)
+    {
+        for (auto& band : bands)
+            band.setDesignMath(math);
+    }
+
+    /**
+     * Bilinear or matched design for every band (see Engine::setDesignMethod).
+     */
+    void setDesignMethod(DesignMethod method)
+    {
+        for (auto& band : bands)
+            band.setDesignMethod(method);
+    }
+
+    /**
+     * Process an audio block in place through all bands.
+     *
+     * @param buffer Audio buffer (1 to BiquadSIMD::maxChannels channels)
+     */
+    void processBlock(juce::AudioBuffer<SampleType>& buffer)
+    {
+        // Taking the write pointers drops the buffer's cleared flag, so read it first.
+        const bool cleared = buffer.hasBeenCleared();
+        processBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), cleared);
+    }
+
+    /**
+     * Process raw channel pointers in place through all bands.
+     *
+     * @param channels Array of channel pointers
+     * @param numChannels Number of channels (1 to BiquadSIMD::maxChannels)
+     * @param numSamples Number of samples to process
+     * @param cleared True if the caller already knows the input is all zeros
+     */
+    void processBlock(SampleType* const* channels, int numChannels, int numSamples, bool cleared = false)
+    {
+        numChannels = std::min(numChannels, BiquadType::maxChannels);
+        if (channels == nullptr || numSamples <= 0 || numChannels <= 0)
+            return;
+
+        FastPathCounters::bump(counters.blocks);
+
+        if (canSkipSilence(numChannels) && (cleared || isDigitalSilence(channels, numChannels, numSamples)))
+        {
+            for (auto& band : chain())
+                band.reset();
+
+            FastPathCounters::bump(counters.silenceSkips);
+            return;
+        }
+
+        if (mode == CascadeMode::PerBand)
+        {
+            // Only the first band's input is the cleared buffer; the others scan.
+            for (auto b{0uz}; b < chain().size(); ++b)
+                bands[b].processBlock(channels, numChannels, numSamples, cleared && b == 0);
+
+            return;
+        }
+
+        if constexpr (hasDF2TKernels)
+        {
+            if (usesSkewed() && numChannels == 2)
+            {
+                processSkewed(channels[0], channels[1], numSamples);
+                return;
+            }
+
+            if (canRunTimeParallel())
+            {
+                processTiled(channels, numChannels, numSamples);
+                return;
+            }
+        }
+
+        if (numChannels == 1)
+        {
+            processFusedMono(channels[0], numSamples);
+        }
+        else
+        {
+            processFused(channels, numChannels, numSamples);
+        }
+    }
+
+private:
+    // The skewed and time-parallel kernels are float DF2T only.
+    static constexpr bool hasDF2TKernels = std::is_same_v<SampleType, float> && std::is_same_v<Topology, DF2T>;
+
+    using BiquadType = Biquad<SampleType, Topology>;
+    using Batch = typename BiquadType::Batch;
+
+    // Samples per channel per tile: small enough that the tile stays in L1
+    // while every band runs over it.
+    static constexpr int tileSize = 256;
+
+    // The bands in the chain.
+    std::span<Engine<SampleType, Topology>> chain() { return { bands.data(), static_cast<size_t>(numBands) }; }
+    std::span<const Engine<SampleType, Topology>> chain() const { return { bands.data(), static_cast<size_t>(numBands) }; }
+
+    bool usesSkewed() const
+    {
+        return hasDF2TKernels && mode == CascadeMode::Skewed && preparedChannels == 2
+               && BiquadSkewedSIMD::isSupported(numBands);
+    }
+
+    // Every band steady with its tail decayed; the skewed kernel's state isn't the bands'.
+    bool canSkipSilence(int numChannels) const
+    {
+        if (! fastPathsEnabled || (usesSkewed() && numChannels == 2))
+            return false;
+
+        for (const auto& band : chain())
+            if (! band.hasSettled())
+                return false;
+
+        return true;
+    }
+
+    bool canRunTimeParallel() const
+    {
+        for (const auto& band : chain())
+            if (band.getKernel() != BiquadKernel::TimeParallel || band.isSmoothing())
+                return false;
+
+        return true;
+    }
+
+    // The time-parallel kernel works along time, so it can't be interleaved
+    // per sample like processFused; running every band over a short tile
+    // keeps the single trip through memory instead.
+    void processTiled(SampleType* const* channels, int numChannels, int numSamples)
+    {
+        std::array<SampleType*, BiquadType::maxChannels> tile{};
+        const auto active = findActiveBands();
+
+        for (int start = 0; start < numSamples; start += tileSize)
+        {
+            const int length = std::min(tileSize, numSamples - start);
+            for (int ch = 0; ch < numChannels; ++ch)
+                tile[static_cast<size_t>(ch)] = channels[ch] + start;
+
+            for (auto b{0uz}; b < chain().size(); ++b)
+                if (active[b])
+                    bands[b].processSteady(tile.data(), numChannels, length);
+        }
+    }
+
+    // skipIfIdentity() for every band in the chain, once per block.
+    std::array<bool, maxBands> findActiveBands()
+    {
+        std::array<bool, maxBands> active {};
+        for (auto b{0uz}; b < chain().size(); ++b)
+            active[b] = ! bands[b].skipIfIdentity();
+
+        return active;
+    }
+
+    void processFused(SampleType* const* channels, int numChannels, int numSamples)
+    {
+        constexpr int lanes = BiquadType::lanes;
+
+        const auto active = findActiveBands();
+        std::array<bool, maxBands> smoothing {};
+        bool anySmoothing = false;
+        for (auto b{0uz}; b < chain().size(); ++b)
+        {
+            smoothing[b] = bands[b].isSmoothing();
+            anySmoothing = anySmoothing || smoothing[b];
+        }
+
+        if (! anySmoothing)
+        {
+            // Steady: the dispatched kernel for the number of bands left after
+            // the skipped ones, with the band loop unrolled.
+            std::array<BiquadLanes<SampleType>*, maxBands> lanesPerBand;
+            int numActive = 0;
+            for (auto b{0uz}; b < chain().size(); ++b)
+                if (active[b])
+                    lanesPerBand[static_cast<size_t>(numActive++)] = &bands[b].getBiquad().getLanes();
+
+            const auto& kernels = Dispatch::getKernels().get<SampleType, Topology>();
+            if (numActive > 0)
+                kernels.cascade[numActive - 1](lanesPerBand.data(), channels, numChannels, numSamples);
+
+            return;
+        }
+
+        std::array<typename BiquadType::Coeffs, maxBands> coeffs;
+        for (auto b{0uz}; b < chain().size(); ++b)
+            coeffs[b] = bands[b].getBiquad().getCoeffs();
+
+        // The smoothers advance once per sample, so the channel groups have
+        // to be visited inside the sample loop; their state stays in memory.
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Coefficient refreshes only happen while a band is still gliding.
+            for (auto b{0uz}; b < chain().size(); ++b)
+            {
+                if (smoothing[b] && bands[b].advanceSmoothing())
+                    coeffs[b] = bands[b].getBiquad().getCoeffs();
+            }
+
+            for (int first = 0, v = 0; first < numChannels; first += lanes, ++v)
+            {
+                const int count = std::min(lanes, numChannels - first);
+                Batch x = BiquadType::Kernels::gather(channels + first, count, i);
+
+                for (auto b{0uz}; b < chain().size(); ++b)
+                {
+                    if (! active[b])
+                        continue;
+
+                    auto& biquad = bands[b].getBiquad();
+                    typename BiquadType::State state = biquad.loadState(v);
+                    x = BiquadType::tick(x, coeffs[b], state);
+                    biquad.storeState(v, state);
+                }
+
+                BiquadType::Kernels::scatter(x, channels + first, count, i);
+            }
+        }
+    }
+
+    // Mono: the same chain in scalar code, the state in locals (two values per band for DF2T).
+    // The state is channel 0's slot of each band, as in BiquadSIMD::processMono.
+    void processFusedMono(SampleType* data, int numSamples)
+    {
+        std::array<std::array<SampleType, BiquadType::numCoeffs>, maxBands> c;
+        std::array<std::array<SampleType, BiquadType::numStates>, maxBands> state;
+        std::array<bool, maxBands> smoothing {};
+
+        // Only the bands that aren't skipped, in chain order.
+        const auto active = findActiveBands();
+        std::array<size_t, maxBands> order;
+        size_t numActive = 0;
+        for (auto b{0uz}; b < chain().size(); ++b)
+            if (active[b])
+                order[numActive++] = b;
+
+        bool anySmoothing = false;
+        for (auto b{0uz}; b < chain().size(); ++b)
+        {
+            auto& biquad = bands[b].getBiquad();
+            biquad.getScalarCoeffs(c[b]);
+            biquad.getScalarState(state[b]);
+            smoothing[b] = bands[b].isSmoothing();
+            anySmoothing = anySmoothing || smoothing[b];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (anySmoothing)
+            {
+                for (auto b{0uz}; b < chain().size(); ++b)
+                {
+                    if (smoothing[b] && bands[b].advanceSmoothing())
+                        bands[b].getBiquad().getScalarCoeffs(c[b]);
+                }
+            }
+
+            SampleType x = data[i];
+            for (size_t n = 0; n < numActive; ++n)
+                x = Topology::tick(x, c[order[n]].data(), state[order[n]].data());
+
+            data[i] = x;
+        }
+
+        for (size_t n = 0; n < numActive; ++n)
+            bands[order[n]].getBiquad().setScalarState(state[order[n]]);
+    }
+
+    void processSkewed(float* leftChannel, float* rightChannel, int numSamples)
+    {
+        bool anySmoothing = false;
+        for (auto b{0uz}; b < chain().size(); ++b)
+        {
+            skewed.setBandCoeffs(b, bands[b].getCoeffs());
+            anySmoothing = anySmoothing || bands[b].isSmoothing();
+        }
+
+        if (! anySmoothing)
+        {
+            skewed.processBlock(leftChannel, rightChannel, numSamples);
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (auto b{0uz}; b < chain().size(); ++b)
+            {
+                if (bands[b].isSmoothing() && bands[b].advanceSmoothing())
+                    skewed.setBandCoeffs(b, bands[b].getCoeffs());
+            }
+
+            skewed.processBlock(leftChannel + i, rightChannel + i, 1);
+        }
+    }
+
+    // Every band there can be; the first numBands run. The plugin's default
+    // layout is 0 = HighShelf, 1 = MidPeak (Peaking), 2 = LowShelf.
+    std::array<Engine<SampleType, Topology>, maxBands> bands;
+    int numBands = defaultNumBands;
+    BiquadSkewedSIMD skewed;
+    FastPathCounters counters;
+    bool fastPathsEnabled = true;
+
+    int preparedChannels = 2;
+
+    CascadeMode mode = CascadeMode::Fused;
+};
+
+#endif
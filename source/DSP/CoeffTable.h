@@ -0,0 +1,367 @@
+#pragma once
+
+#ifndef BIQUAD3_COEFFTABLE_H
+#define BIQUAD3_COEFFTABLE_H
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Qcalc.h"
+
+/**
+ * Qcalc designs precomputed on a log-frequency x gain grid, for one sample
+ * rate and one Q/slope control (the plugin's is fixed, see defaultQ).
+ *
+ * Every filter type and Q mode has its own slice; the Q mode only changes the
+ * peaking design, so that's four slices: peaking (constant Q), low shelf,
+ * high shelf and peaking (proportional Q). Nodes are 256 log-spaced
+ * frequencies from 20 Hz to min(20 kHz, 0.48 * sampleRate) by 0.5 dB gain
+ * steps over +/-24 dB, with one padding node on every side, ~1 MB per slice.
+ *
+ * lookup() interpolates the five coefficients bicubically (Catmull-Rom) from
+ * the 4x4 nodes around the point: one log() and 80 multiply-adds instead of
+ * Qcalc's exp/sin/cos/sqrt and divisions. That's only a win with FMA and a
+ * slow libm; against glibc at the SSE2 baseline it's about even, which is
+ * why the plugin only uses it with the BIQUAD3_COEFF_TABLE build option.
+ * In proportional Q mode Q bends at
+ * 0 dB and +/-12 dB (peakingQ()); the gain stencil doesn't reach across those
+ * nodes, it extends the cell linearly instead. Against Qcalc::calculate the
+ * magnitude responses stay within ~0.015 dB (scripts/CoeffTableBench.cpp
+ * reports it per sample rate). Out-of-range points, and calculate() with a Q
+ * other than the table's, go to Qcalc.
+ *
+ * Tables are immutable once built. getShared() hands every caller (every
+ * plugin instance in the process) the same one per sample rate and Q, and
+ * builds it on first use. With a cache directory it's also written there and
+ * memory-mapped on later startups instead of rebuilt.
+ */
+class CoeffTable {
+public:
+    static constexpr double minFrequency = 20.0;
+    static constexpr double maxFrequency = 20000.0;
+    static constexpr double maxGainDB = 24.0;
+    static constexpr double gainStepDB = 0.5;
+
+    // Grid sizes, padding included.
+    static constexpr int numFrequencies = 256 + 2;
+    static constexpr int numGains = static_cast<int>(2.0 * maxGainDB / gainStepDB) + 1 + 2;
+    static constexpr int numSlices = 4;
+    static constexpr size_t nodesPerSlice = static_cast<size_t>(numFrequencies) * numGains;
+
+    /**
+     * Build the table (a few ms, allocates; not for the audio thread).
+     *
+     * @param sampleRate The sample rate in Hz
+     * @param qControl The Q (peaking) / slope (shelves) the table is for
+     */
+    CoeffTable(double sampleRate, double qControl)
+        : CoeffTable(sampleRate, qControl, nullptr)
+    {
+        storage.resize(nodesPerSlice * numSlices);
+        nodes = storage.data();
+        build();
+    }
+
+    /**
+     * The table for this sample rate and Q shared by the whole process; built,
+     * or read from cacheDirectory, the first time it's asked for.
+     * Holds a lock while building, so call it from prepareToPlay(), not from
+     * the audio thread.
+     *
+     * @param cacheDirectory Where to keep the table between runs (none if default-constructed)
+     */
+    static std::shared_ptr<const CoeffTable> getShared(double sampleRate, double qControl,
+                                                       const juce::File& cacheDirectory = {})
+    {
+        static std::mutex registryLock;
+        static std::vector<std::weak_ptr<const CoeffTable>> registry;
+
+        const std::scoped_lock lock(registryLock);
+
+        std::erase_if(registry, [](const auto& entry) { return entry.expired(); });
+        for (const auto& entry : registry)
+            if (auto table = entry.lock(); table != nullptr && table->sampleRate == sampleRate && table->q == qControl)
+                return table;
+
+        std::shared_ptr<const CoeffTable> table;
+        if (cacheDirectory != juce::File())
+        {
+            const auto file = cacheDirectory.getChildFile(getCacheFileName(sampleRate, qControl));
+            table = loadFrom(file, sampleRate, qControl);
+            if (table == nullptr)
+            {
+                auto built = std::make_shared<CoeffTable>(sampleRate, qControl);
+                if (cacheDirectory.createDirectory().wasOk())
+                    built->saveTo(file);
+                table = std::move(built);
+            }
+        }
+        else
+        {
+            table = std::make_shared<CoeffTable>(sampleRate, qControl);
+        }
+
+        registry.push_back(table);
+        return table;
+    }
+
+    /**
+     * Interpolate the design at (frequency, gainDB) for this table's Q.
+     * Real-time safe.
+     *
+     * @return false (and out untouched) if the point lies outside the table
+     */
+    bool lookup(double frequency, double gainDB, QMode mode, FilterType type, BiquadCoeffs& out) const noexcept
+    {
+        if (! (frequency >= minFrequency && frequency <= topFrequency && std::abs(gainDB) <= maxGainDB))
+            return false;
+
+        // Grid coordinates; node 0 is padding, so the cell's left node is at least 1.
+        const double u = (std::log(frequency) - logMinFrequency) * inverseLogStep + 1.0;
+        const double v = (gainDB + maxGainDB) * (1.0 / gainStepDB) + 1.0;
+        const int i = std::min(static_cast<int>(u), numFrequencies - 3);
+        const int j = std::min(static_cast<int>(v), numGains - 3);
+
+        const auto wf = catmullRom(u - i);
+        auto wg = catmullRom(v - j);
+
+        const int slice = getSliceIndex(mode, type);
+        if (slice == proportionalPeakingSlice)
+        {
+            // Extend the cell linearly past a kink: p[-1] = 2 p[0] - p[1].
+            if (isKinkNode(j))
+            {
+                wg[1] += 2.0 * wg[0];
+                wg[2] -= wg[0];
+                wg[0] = 0.0;
+            }
+            if (isKinkNode(j + 1))
+            {
+                wg[2] += 2.0 * wg[3];
+                wg[1] -= wg[3];
+                wg[3] = 0.0;
+            }
+        }
+
+        const BiquadCoeffs* row = nodes + static_cast<size_t>(slice) * nodesPerSlice
+                                        + static_cast<size_t>(i - 1) * numGains + (j - 1);
+
+        // Along gain in each of the four frequency rows, then across the rows;
+        // short independent sums instead of one 16-term chain per coefficient.
+        BiquadCoeffs sum { 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (int a = 0; a < 4; ++a, row += numGains)
+        {
+            BiquadCoeffs r { 0.0, 0.0, 0.0, 0.0, 0.0 };
+            for (int b = 0; b < 4; ++b)
+            {
+                const double w = wg[static_cast<size_t>(b)];
+                r.b0 += w * row[b].b0;
+                r.b1 += w * row[b].b1;
+                r.b2 += w * row[b].b2;
+                r.a1 += w * row[b].a1;
+                r.a2 += w * row[b].a2;
+            }
+
+            const double w = wf[static_cast<size_t>(a)];
+            sum.b0 += w * r.b0;
+            sum.b1 += w * r.b1;
+            sum.b2 += w * r.b2;
+            sum.a1 += w * r.a1;
+            sum.a2 += w * r.a2;
+        }
+
+        out = sum;
+        return true;
+    }
+
+    /**
+     * Drop-in for Qcalc::calculate at this table's sample rate: the table when
+     * it covers the point and Q, Qcalc otherwise.
+     */
+    BiquadCoeffs calculate(double frequency, double gainDB, double qControl, QMode mode, FilterType type) const
+    {
+        BiquadCoeffs coeffs;
+        if (qControl == q && lookup(frequency, gainDB, mode, type, coeffs))
+            return coeffs;
+
+        return Qcalc::calculate(sampleRate, frequency, gainDB, qControl, mode, type);
+    }
+
+    /**
+     * Write the table to a file for loadFrom(). Goes through a temporary file,
+     * so other processes never map a half-written one.
+     */
+    bool saveTo(const juce::File& file) const
+    {
+        const FileHeader header = makeHeader(sampleRate, q, topFrequency);
+
+        juce::TemporaryFile temp(file);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (! out.openedOk()
+                || ! out.write(&header, sizeof(header))
+                || ! out.write(nodes, getSizeInBytes()))
+                return false;
+
+            out.flush();
+            if (out.getStatus().failed())
+                return false;
+        }
+
+        return temp.overwriteTargetFileWithTemporary();
+    }
+
+    /**
+     * Map a table written by saveTo(). The nodes are used in place, not copied.
+     *
+     * @return nullptr if the file is missing, or from another grid layout,
+     *         sample rate or Q
+     */
+    static std::unique_ptr<CoeffTable> loadFrom(const juce::File& file, double sampleRate, double qControl)
+    {
+        if (! file.existsAsFile())
+            return nullptr;
+
+        auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        if (mapped->getData() == nullptr || mapped->getSize() != sizeof(FileHeader) + nodesPerSlice * numSlices * sizeof(BiquadCoeffs))
+            return nullptr;
+
+        std::unique_ptr<CoeffTable> table(new CoeffTable(sampleRate, qControl, std::move(mapped)));
+
+        FileHeader header;
+        std::memcpy(&header, table->mapped->getData(), sizeof(header));
+        const FileHeader expected = makeHeader(sampleRate, qControl, table->topFrequency);
+        if (std::memcmp(&header, &expected, sizeof(header)) != 0)
+            return nullptr;
+
+        table->nodes = reinterpret_cast<const BiquadCoeffs*>(static_cast<const char*>(table->mapped->getData()) + sizeof(FileHeader));
+        return table;
+    }
+
+    static juce::String getCacheFileName(double sampleRate, double qControl)
+    {
+        return "CoeffTable-" + juce::String(sampleRate, 3) + "-" + juce::String(qControl, 6) + ".bin";
+    }
+
+    double getSampleRate() const { return sampleRate; }
+    double getQ() const { return q; }
+
+    // Upper end of the covered frequency range, in Hz.
+    double getTopFrequency() const { return topFrequency; }
+
+    size_t getSizeInBytes() const { return nodesPerSlice * numSlices * sizeof(BiquadCoeffs); }
+
+    // True if the nodes are memory-mapped from a cache file.
+    bool isMapped() const { return mapped != nullptr; }
+
+private:
+    static constexpr int proportionalPeakingSlice = 3;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version, frequencies, gains, slices;
+        double sampleRate, qControl, topFrequency;
+    };
+
+    static_assert(sizeof(FileHeader) % alignof(BiquadCoeffs) == 0, "Nodes follow the header in the cache file.");
+
+    CoeffTable(double rate, double qControl, std::unique_ptr<juce::MemoryMappedFile> file)
+        : sampleRate(rate),
+          q(qControl),
+          topFrequency(std::min(maxFrequency, 0.48 * rate)),
+          logMinFrequency(std::log(minFrequency)),
+          inverseLogStep((numFrequencies - 3) / (std::log(topFrequency) - logMinFrequency)),
+          mapped(std::move(file))
+    {
+    }
+
+    static FileHeader makeHeader(double sampleRate, double qControl, double topFrequency)
+    {
+        FileHeader header {};
+        std::memcpy(header.magic, "BQ3COEFF", sizeof(header.magic));
+        header.version = 1;
+        header.frequencies = numFrequencies;
+        header.gains = numGains;
+        header.slices = numSlices;
+        header.sampleRate = sampleRate;
+        header.qControl = qControl;
+        header.topFrequency = topFrequency;
+        return header;
+    }
+
+    static int getSliceIndex(QMode mode, FilterType type) noexcept
+    {
+        if (type == FilterType::Peaking && mode == QMode::Proportional_Q)
+            return proportionalPeakingSlice;
+
+        return static_cast<int>(type);
+    }
+
+    // Gain nodes where peakingQ() has a kink: 0 dB and +/-12 dB.
+    static constexpr bool isKinkNode(int node) noexcept
+    {
+        constexpr int nodesPerKink = static_cast<int>(12.0 / gainStepDB);
+        const int offset = node - 1 - static_cast<int>(maxGainDB / gainStepDB);
+        return offset % nodesPerKink == 0 && offset != -2 * nodesPerKink && offset != 2 * nodesPerKink;
+    }
+
+    static std::array<double, 4> catmullRom(double t) noexcept
+    {
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        return { -0.5 * t3 + t2 - 0.5 * t,
+                  1.5 * t3 - 2.5 * t2 + 1.0,
+                 -1.5 * t3 + 2.0 * t2 + 0.5 * t,
+                  0.5 * t3 - 0.5 * t2 };
+    }
+
+    // One calculateBatch() run per slice over every node.
+    void build()
+    {
+        std::vector<double> frequency(nodesPerSlice), gain(nodesPerSlice), qControl(nodesPerSlice, q);
+        std::vector<double> b0(nodesPerSlice), b1(nodesPerSlice), b2(nodesPerSlice), a1(nodesPerSlice), a2(nodesPerSlice);
+
+        const double logStep = 1.0 / inverseLogStep;
+        for (int i = 0; i < numFrequencies; ++i)
+        {
+            for (int j = 0; j < numGains; ++j)
+            {
+                const auto n = static_cast<size_t>(i) * numGains + static_cast<size_t>(j);
+                frequency[n] = std::exp(logMinFrequency + (i - 1) * logStep);
+                gain[n] = (j - 1) * gainStepDB - maxGainDB;
+            }
+        }
+
+        for (int slice = 0; slice < numSlices; ++slice)
+        {
+            const auto type = slice == proportionalPeakingSlice ? FilterType::Peaking : static_cast<FilterType>(slice);
+            const auto mode = slice == proportionalPeakingSlice ? QMode::Proportional_Q : QMode::Constant_Q;
+            const std::vector<FilterType> types(nodesPerSlice, type);
+
+            Qcalc::calculateBatch<double>(sampleRate, frequency, gain, qControl, types, mode, { b0, b1, b2, a1, a2 });
+
+            BiquadCoeffs* out = storage.data() + static_cast<size_t>(slice) * nodesPerSlice;
+            for (size_t n = 0; n < nodesPerSlice; ++n)
+                out[n] = { b0[n], b1[n], b2[n], a1[n], a2[n] };
+        }
+    }
+
+    double sampleRate;
+    double q;
+    double topFrequency;
+    double logMinFrequency;
+    double inverseLogStep;
+
+    // Nodes: [slice][frequency][gain], in storage or in the mapped file.
+    std::vector<BiquadCoeffs> storage;
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+    const BiquadCoeffs* nodes = nullptr;
+};
+
+#endif // BIQUAD3_COEFFTABLE_H
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef BIQUAD3_DISPATCH_H
+#define BIQUAD3_DISPATCH_H
+
+#include "BiquadKernels.h"
+
+/*
+ * Runtime selection of the block kernels.
+ *
+ * Each architecture in DispatchArchs has its own translation unit
+ * (DispatchSSE2.cpp, DispatchAVX2.cpp, ...) compiled with that ISA enabled; see
+ * the per-file options in CMakeLists.txt. Everything else, this header
+ * included, is built for the baseline, so the binary still loads on any CPU
+ * of the target platform.
+ *
+ * The CPU is probed once, on the first call to Dispatch::getKernels(). The
+ * PluginProcessor constructor makes that call, so the audio thread never does.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define BIQUAD3_DISPATCH_X86 1
+    using DispatchArchs = xsimd::arch_list<xsimd::avx512f, xsimd::fma3<xsimd::avx2>, xsimd::sse2>;
+#elif defined(__arm64__) || defined(__aarch64__) || defined(_M_ARM64)
+    #define BIQUAD3_DISPATCH_ARM64 1
+    using DispatchArchs = xsimd::arch_list<xsimd::neon64>;
+#else
+    #error "Unsupported architecture: requires ARM64 (NEON) or x86/x86_64 (SSE2)"
+#endif
+
+// Defined in the per-architecture translation units.
+#if BIQUAD3_DISPATCH_X86
+extern template KernelTable KernelSelector::operator()<xsimd::avx512f>(xsimd::avx512f) const;
+extern template KernelTable KernelSelector::operator()<xsimd::fma3<xsimd::avx2>>(xsimd::fma3<xsimd::avx2>) const;
+extern template KernelTable KernelSelector::operator()<xsimd::sse2>(xsimd::sse2) const;
+#elif BIQUAD3_DISPATCH_ARM64
+extern template KernelTable KernelSelector::operator()<xsimd::neon64>(xsimd::neon64) const;
+#endif
+
+namespace Dispatch {
+
+/**
+ * The kernels for the widest instruction set this CPU supports.
+ */
+inline const KernelTable& getKernels() noexcept
+{
+    static const KernelTable kernels = xsimd::dispatch<DispatchArchs>(KernelSelector{})();
+    return kernels;
+}
+
+/**
+ * Name of the active kernel set, e.g. "avx512f", "fma3+avx2", "sse2", "neon64".
+ */
+inline const char* getActiveKernelName() noexcept { return getKernels().name; }
+
+/**
+ * Floats per vector of the active kernel set.
+ */
+inline int getActiveLaneCount() noexcept { return getKernels().lanes; }
+
+} // namespace Dispatch
+
+#endif
@@ -0,0 +1,6 @@
+// Built with -mavx2 -mfma (/arch:AVX2), see CMakeLists.txt. Only reached through Dispatch.h.
+#include "BiquadKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+template KernelTable KernelSelector::operator()<xsimd::fma3<xsimd::avx2>>(xsimd::fma3<xsimd::avx2>) const;
+#endif
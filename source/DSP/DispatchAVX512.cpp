@@ -0,0 +1,6 @@
+// Built with -mavx512f -mfma (/arch:AVX512), see CMakeLists.txt. Only reached through Dispatch.h.
+#include "BiquadKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+template KernelTable KernelSelector::operator()<xsimd::avx512f>(xsimd::avx512f) const;
+#endif
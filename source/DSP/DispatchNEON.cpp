@@ -0,0 +1,6 @@
+// Built with the baseline flags. Only reached through Dispatch.h.
+#include "BiquadKernels.h"
+
+#if defined(__arm64__) || defined(__aarch64__) || defined(_M_ARM64)
+template KernelTable KernelSelector::operator()<xsimd::neon64>(xsimd::neon64) const;
+#endif
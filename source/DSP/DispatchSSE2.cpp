@@ -0,0 +1,6 @@
+// Built with the baseline flags. Only reached through Dispatch.h.
+#include "BiquadKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+template KernelTable KernelSelector::operator()<xsimd::sse2>(xsimd::sse2) const;
+#endif
@@ -1,29 +1,122 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 #include "Qcalc.h"
+#include "CoeffTable.h"
+#include "Topology.h"
 
-// Auto-select the correct SIMD architecture
-#if defined(__arm64__) || defined(__aarch64__) || defined(_M_ARM64)
-    // ARM64: Apple Silicon (M1/M2/M3), ARM-based devices
-    #include "BiquadNEON.h"
-    using Biquad = BiquadNEON;
-#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
-    // x86/x86_64: Intel/AMD processors
-    #include "BiquadAVX.h"
-    using Biquad = BiquadAVX;
-#else
-    #error "Unsupported architecture: requires ARM64 (NEON) or x86/x86_64 (AVX)"
-#endif
+// The instruction set is picked at runtime, see Dispatch.h.
+#include "BiquadSIMD.h"
+
+template <typename SampleType, typename Topology = DF2T>
+using Biquad = BiquadSIMD<SampleType, Topology>;
+
+#include "BiquadBlockSIMD.h"
+
+/**
+ * Steady-state kernel choice.
+ * Lanewise puts one channel per SIMD lane (BiquadSIMD); TimeParallel runs
+ * one vector of consecutive samples of a channel at a time (BiquadBlockSIMD).
+ * While parameters are smoothing both use the per-sample lanewise path.
+ * TimeParallel is float DF2T only; every other Engine always runs Lanewise.
+ */
+enum class BiquadKernel { Lanewise, TimeParallel };
+
+/**
+ * How often the skip paths were taken, in blocks. Only the audio thread
+ * counts; any thread may read. A reset() racing with the audio thread may
+ * lose a count or two.
+ */
+struct FastPathCounters
+{
+    std::atomic<std::uint64_t> blocks { 0 };        // blocks seen
+    std::atomic<std::uint64_t> identitySkips { 0 }; // skipped: unity band, decayed state
+    std::atomic<std::uint64_t> silenceSkips { 0 };  // skipped: silent input, decayed state
+
+    // Single writer, so a relaxed load and store is enough (no locked add).
+    static void bump(std::atomic<std::uint64_t>& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept
+    {
+        blocks.store(0, std::memory_order_relaxed);
+        identitySkips.store(0, std::memory_order_relaxed);
+        silenceSkips.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * True if every sample of every channel is exactly zero. Gives up at the
+ * first chunk that isn't, so ordinary audio costs a few compares.
+ */
+template <typename SampleType>
+bool isDigitalSilence(const SampleType* const* channelData, int numChannels, int numSamples) noexcept
+{
+    constexpr int chunk = 64;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const SampleType* data = channelData[ch];
+        for (int start = 0; start < numSamples; start += chunk)
+        {
+            const int end = std::min(numSamples, start + chunk);
+
+            bool nonZero = false;
+            for (int i = start; i < end; ++i)
+                nonZero |= data[i] != SampleType(0);
+
+            if (nonZero)
+                return false;
+        }
+    }
+
+    return true;
+}
 
 /**
  * Biquad Engine with parameter smoothing.
  * 
  * Wraps a SIMD-optimized Biquad filter with smooth parameter transitions
  * to avoid clicks and zipper noise when parameters change.
+ *
+ * SampleType is float or double, matching the host's processing precision.
+ * Topology is the filter structure (Topology.h). DF2T, DF1 and Lattice are fed
+ * by Qcalc; TPTSVF is designed straight from the analog prototype, one tan()
+ * per coefficient update, which makes it the cheapest one to glide.
+ *
+ * While smoothing, the coefficients are recomputed every sample by default.
+ * setControlInterval(N) recomputes them every N samples instead and ramps
+ * linearly in between (see advanceSmoothing()).
+ *
+ * Steady blocks can skip the filter altogether (see skipIfIdentity()):
+ * a unity band (0 dB gain, DF2T) or digital silence in, once the state has
+ * decayed below decayThreshold. The state is zeroed on the way in. For a
+ * unity DF2T and for silent input that's where the filter settles anyway,
+ * so both the step into the skip (at most decayThreshold) and the step out
+ * of it are inaudible. getFastPathCounters() shows how often this happens.
  */
+template <typename SampleType, typename Topology = DF2T>
 class Engine {
 public:
+    // Longest supported coefficient update interval, in samples.
+    static constexpr int maxControlInterval = 256;
+
+    // Gains closer to 0 dB than this get exactly unity coefficients (b == a),
+    // the same resolution advanceSmoothing() redesigns at.
+    static constexpr float unityGainDB = 0.001f;
+
+    // State magnitude below which a steady band counts as decayed: -160 dBFS,
+    // well under the last bit of 24-bit audio.
+    static constexpr SampleType decayThreshold = SampleType(1.0e-8);
+
     Engine() = default;
 
     /**
@@ -98,118 +191,244 @@ public:
     }
 
     /**
-     * Process a stereo audio block with parameter smoothing.
+     * Process an audio block with parameter smoothing.
      * Coefficients are updated per-sample when parameters are changing.
      * 
-     * @param buffer Audio buffer to process in-place (must have at least 2 channels)
+     * @param buffer Audio buffer to process in-place (1 to BiquadSIMD::maxChannels channels)
+     */
+    void processBlock(juce::AudioBuffer<SampleType>& buffer)
+    {
+        // Taking the write pointers drops the buffer's cleared flag, so read it first.
+        const bool cleared = buffer.hasBeenCleared();
+        processBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), cleared);
+    }
+
+    /**
+     * Process an audio block using raw channel pointers.
+     * 
+     * @param channelData Array of channel pointers
+     * @param numChannels Number of channels (mono uses a dedicated scalar kernel)
+     * @param numSamples Number of samples to process
+     * @param knownSilent True if the caller already knows the input is all
+     *                    zeros (e.g. a cleared buffer), which saves the scan
      */
-    void processBlock(juce::AudioBuffer<float>& buffer)
+    void processBlock(SampleType* const* channelData, int numChannels, int numSamples, bool knownSilent = false)
     {
-        const int numSamples = buffer.getNumSamples();
-        if (numSamples == 0 || buffer.getNumChannels() < 2)
+        if (channelData == nullptr || numChannels <= 0 || numSamples <= 0)
             return;
 
-        float* leftChannel = buffer.getWritePointer(0);
-        float* rightChannel = buffer.getWritePointer(1);
+        if (skipIfIdentity())
+            return;
 
-        // Check if any parameters are still smoothing
-        const bool isSmoothing = smoothedFrequency.isSmoothing() ||
-                                  smoothedGainDB.isSmoothing() ||
-                                  smoothedQ.isSmoothing();
+        if (fastPathsEnabled && hasSettled() && (knownSilent || isDigitalSilence(channelData, numChannels, numSamples)))
+        {
+            // Zero in, zero out: the output is already in place.
+            biquad.reset();
+            FastPathCounters::bump(counters.silenceSkips);
+            return;
+        }
 
-        if (isSmoothing)
+        if (isSmoothing() && controlInterval > 1)
+        {
+            processControlRate(channelData, numChannels, numSamples);
+        }
+        else if (isSmoothing())
         {
             // Process sample-by-sample with coefficient updates
             for (int i = 0; i < numSamples; ++i)
             {
-                // Advance smoothed values
-                const float freq = smoothedFrequency.getNextValue();
-                const float gain = smoothedGainDB.getNextValue();
-                const float q = smoothedQ.getNextValue();
-
-                // Update coefficients if values changed significantly
-                if (std::abs(freq - lastFrequency) > 0.01f ||
-                    std::abs(gain - lastGainDB) > 0.001f ||
-                    std::abs(q - lastQ) > 0.0001f)
-                {
-                    lastFrequency = freq;
-                    lastGainDB = gain;
-                    lastQ = q;
-                    
-                    auto coeffs = Qcalc::calculate(currentSampleRate,
-                                                   static_cast<double>(freq),
-                                                   static_cast<double>(gain),
-                                                   static_cast<double>(q),
-                                                   qMode, filterType);
-                    biquad.setCoeffs(coeffs);
-                }
+                advanceSmoothing();
 
-                // Process single stereo sample
-                biquad.processStereo(&leftChannel[i], &rightChannel[i],
-                                     &leftChannel[i], &rightChannel[i]);
+                // Process one sample of every channel
+                biquad.processFrame(channelData, numChannels, i);
             }
         }
         else
         {
             // No smoothing needed - process entire block at once (more efficient)
-            float* channels[2] = { leftChannel, rightChannel };
-            biquad.processBlock(channels, numSamples);
+            processSteady(channelData, numChannels, numSamples);
         }
     }
 
     /**
-     * Process a stereo audio block using raw channel pointers.
-     * 
-     * @param channelData Array of channel pointers [left, right]
-     * @param numSamples Number of samples to process
+     * Advance the smoothed parameters by one sample and recalculate the
+     * coefficients if the values changed significantly.
+     * Used by the per-sample loops here and by Cascade's fused kernel.
+     *
+     * With a control interval above 1, the smoothers and the coefficient
+     * design only run at the start of each interval, and each call in between
+     * moves the coefficients one step along the ramp.
+     *
+     * @return true if new coefficients were written to the biquad
      */
-    void processBlock(float* const* channelData, int numSamples)
+    bool advanceSmoothing()
     {
-        if (channelData == nullptr || numSamples <= 0)
-            return;
+        if (controlInterval > 1)
+        {
+            if (! biquad.isRamping())
+            {
+                if (! smoothersActive())
+                    return false;
 
-        float* leftChannel = channelData[0];
-        float* rightChannel = channelData[1];
+                beginRamp();
+            }
 
-        if (leftChannel == nullptr || rightChannel == nullptr)
-            return;
+            biquad.stepRamp();
+            syncRampedCoeffs();
+            return true;
+        }
 
-        const bool isSmoothing = smoothedFrequency.isSmoothing() ||
-                                  smoothedGainDB.isSmoothing() ||
-                                  smoothedQ.isSmoothing();
+        const float freq = smoothedFrequency.getNextValue();
+        const float gain = smoothedGainDB.getNextValue();
+        const float q = smoothedQ.getNextValue();
 
-        if (isSmoothing)
+        // Update coefficients if values changed significantly
+        if (std::abs(freq - lastFrequency) > 0.01f ||
+            std::abs(gain - lastGainDB) > 0.001f ||
+            std::abs(q - lastQ) > 0.0001f)
         {
-            for (int i = 0; i < numSamples; ++i)
-            {
-                const float freq = smoothedFrequency.getNextValue();
-                const float gain = smoothedGainDB.getNextValue();
-                const float q = smoothedQ.getNextValue();
-
-                if (std::abs(freq - lastFrequency) > 0.01f ||
-                    std::abs(gain - lastGainDB) > 0.001f ||
-                    std::abs(q - lastQ) > 0.0001f)
-                {
-                    lastFrequency = freq;
-                    lastGainDB = gain;
-                    lastQ = q;
-                    
-                    auto coeffs = Qcalc::calculate(currentSampleRate,
-                                                   static_cast<double>(freq),
-                                                   static_cast<double>(gain),
-                                                   static_cast<double>(q),
-                                                   qMode, filterType);
-                    biquad.setCoeffs(coeffs);
-                }
+            lastFrequency = freq;
+            lastGainDB = gain;
+            lastQ = q;
 
-                biquad.processStereo(&leftChannel[i], &rightChannel[i],
-                                     &leftChannel[i], &rightChannel[i]);
-            }
+            designCoefficients(freq, gain, q);
+            return true;
         }
-        else
+
+        return false;
+    }
+
+    /**
+     * True if the band is steady at unity gain and its structure can skip it
+     * (Topology::zeroStateAtUnity). Its output may still carry a decaying tail.
+     */
+    bool isIdentity() const
+    {
+        return Topology::zeroStateAtUnity && unityDesign && ! isSmoothing();
+    }
+
+    /**
+     * True if the band is steady and its state has decayed below
+     * decayThreshold, so with silent input its output would be too.
+     */
+    bool hasSettled() const
+    {
+        return ! isSmoothing() && biquad.isStateBelow(decayThreshold);
+    }
+
+    /**
+     * Start-of-block check for the skip paths, also used by Cascade. Counts
+     * the block; if the band is an identity whose tail has decayed, zeroes
+     * the state, counts the skip and returns true: the band can be left out
+     * of this block. Call once per block, before processing it.
+     */
+    bool skipIfIdentity()
+    {
+        FastPathCounters::bump(counters.blocks);
+
+        if (! fastPathsEnabled || ! isIdentity() || ! biquad.isStateBelow(decayThreshold))
+            return false;
+
+        biquad.reset();
+        FastPathCounters::bump(counters.identitySkips);
+        return true;
+    }
+
+    const FastPathCounters& getFastPathCounters() const { return counters; }
+    void resetFastPathCounters() { counters.reset(); }
+
+    /**
+     * Turn the skip paths off, e.g. for A/B runs against the full filter.
+     * On by default. Blocks are still counted.
+     */
+    void setFastPathsEnabled(bool enabled) { fastPathsEnabled = enabled; }
+    bool getFastPathsEnabled() const { return fastPathsEnabled; }
+
+    /**
+     * Access the underlying biquad (coefficients and delay line).
+     */
+    Biquad<SampleType, Topology>& getBiquad() { return biquad; }
+
+    /**
+     * The coefficients currently loaded into the biquad, in double precision.
+     * Only for structures fed by Qcalc; TPTSVF never forms a BiquadCoeffs.
+     * During a control-rate ramp this follows the ramp for DF1/DF2T and is
+     * the ramp's target for the lattice.
+     */
+    const BiquadCoeffs& getCoeffs() const requires (! Topology::prototypeDesign) { return currentCoeffs; }
+
+    /**
+     * Select the kernel used for blocks where no parameter is smoothing.
+     * Safe to change between blocks; both kernels share the delay line.
+     */
+    void setKernel(BiquadKernel newKernel) { kernel = newKernel; }
+    BiquadKernel getKernel() const { return kernel; }
+
+    /**
+     * Recompute the coefficients every `numSamples` samples while smoothing and
+     * ramp them linearly in between; 1 (the default) recomputes every sample.
+     * 16-64 removes nearly all of the design cost at 44.1-96 kHz while
+     * keeping the glide smooth. A glide may end up to numSamples - 1 samples
+     * later than with per-sample updates.
+     *
+     * Safe to change between blocks; a running ramp jumps to its end.
+     */
+    void setControlInterval(int numSamples)
+    {
+        biquad.finishRamp();
+        syncRampedCoeffs();
+        controlInterval = std::clamp(numSamples, 1, maxControlInterval);
+    }
+
+    int getControlInterval() const { return controlInterval; }
+
+    /**
+     * Design from a precomputed table (CoeffTable.h) instead of calling Qcalc
+     * for every coefficient update; nullptr (the default) goes back to Qcalc.
+     * Only used while the table's sample rate matches prepare()'s; points and
+     * Qs it doesn't cover still go to Qcalc. The SVF designs from its analog
+     * prototype and ignores it.
+     * Set it between blocks; takes effect at the next coefficient update.
+     */
+    void setCoefficientTable(std::shared_ptr<const CoeffTable> table) { coeffTable = std::move(table); }
+
+    /**
+     * Design with FastMath's polynomials instead of libm (Qcalc::calculateFast):
+     * two to three times cheaper per coefficient update, within ~1e-7 dB of the
+     * exact design. Exact by default. A coefficient table, if set, still
+     * comes first; the SVF's prototype design always uses libm.
+     * Set it between blocks; takes effect at the next coefficient update.
+     */
+    void setDesignMath(DesignMath math) { designMath = math; }
+    DesignMath getDesignMath() const { return designMath; }
+
+    /**
+     * Bilinear (RBJ, the default) or matched (Qcalc::calculateMatched)
+     * designs. Matched follows the analog shape up to Nyquist, so high
+     * bands need no oversampling to look right, for about four times the cost
+     * of a coefficient update. It bypasses the coefficient table and the
+     * polynomial math, which are both bilinear; the SVF ignores it.
+     * Set it between blocks; takes effect at the next coefficient update.
+     */
+    void setDesignMethod(DesignMethod method) { designMethod = method; }
+    DesignMethod getDesignMethod() const { return designMethod; }
+
+    /**
+     * Process a block with the selected steady-state kernel.
+     * Only valid while isSmoothing() is false.
+     */
+    void processSteady(SampleType* const* channelData, int numChannels, int numSamples)
+    {
+        if constexpr (hasTimeParallel)
         {
-            biquad.processBlock(channelData, numSamples);
+            if (kernel == BiquadKernel::TimeParallel)
+            {
+                blockBiquad.processBlock(channelData, numChannels, numSamples, biquad);
+                return;
+            }
         }
+
+        biquad.processBlock(channelData, numChannels, numSamples);
     }
 
     /**
@@ -222,13 +441,12 @@ public:
     }
 
     /**
-     * Check if parameters are currently smoothing.
+     * Check if parameters are currently smoothing (or a coefficient ramp is
+     * still running).
      */
     bool isSmoothing() const
     {
-        return smoothedFrequency.isSmoothing() ||
-               smoothedGainDB.isSmoothing() ||
-               smoothedQ.isSmoothing();
+        return smoothersActive() || biquad.isRamping();
     }
 
     /**
@@ -247,22 +465,184 @@ public:
     float getCurrentQ() const { return smoothedQ.getCurrentValue(); }
 
 private:
+    static constexpr bool hasTimeParallel = std::is_same_v<SampleType, float> && std::is_same_v<Topology, DF2T>;
+
     void updateCoefficients()
     {
         lastFrequency = smoothedFrequency.getCurrentValue();
         lastGainDB = smoothedGainDB.getCurrentValue();
         lastQ = smoothedQ.getCurrentValue();
 
-        auto coeffs = Qcalc::calculate(currentSampleRate,
-                                       static_cast<double>(lastFrequency),
-                                       static_cast<double>(lastGainDB),
-                                       static_cast<double>(lastQ),
-                                       qMode, filterType);
-        biquad.setCoeffs(coeffs);
+        designCoefficients(lastFrequency, lastGainDB, lastQ);
+    }
+
+    void designCoefficients(float freq, float gain, float q)
+    {
+        biquad.setParams(designParams(freq, gain, q));
+    }
+
+    // Also tracks whether the design is unity, for isIdentity().
+    typename Topology::Params designParams(float freq, float gain, float q)
+    {
+        if constexpr (Topology::prototypeDesign)
+        {
+            return Topology::fromPrototype(currentSampleRate,
+                                           static_cast<double>(freq),
+                                           static_cast<double>(gain),
+                                           static_cast<double>(q),
+                                           qMode, filterType);
+        }
+        else
+        {
+            BiquadCoeffs coeffs;
+            if (designMethod == DesignMethod::Matched)
+                coeffs = Qcalc::calculateMatched(currentSampleRate,
+                                                 static_cast<double>(freq),
+                                                 static_cast<double>(gain),
+                                                 static_cast<double>(q),
+                                                 qMode, filterType);
+            else if (coeffTable != nullptr && coeffTable->getSampleRate() == currentSampleRate)
+                coeffs = coeffTable->calculate(static_cast<double>(freq),
+                                               static_cast<double>(gain),
+                                               static_cast<double>(q),
+                                               qMode, filterType);
+            else if (designMath == DesignMath::Fast)
+                coeffs = Qcalc::calculateFast(currentSampleRate,
+                                              static_cast<double>(freq),
+                                              static_cast<double>(gain),
+                                              static_cast<double>(q),
+                                              qMode, filterType);
+            else
+                coeffs = Qcalc::calculate(currentSampleRate,
+                                          static_cast<double>(freq),
+                                          static_cast<double>(gain),
+                                          static_cast<double>(q),
+                                          qMode, filterType);
+
+            // Exact zeros on the poles, whatever the design path rounded to,
+            // so a unity DF2T's state decays to zero (skipIfIdentity()).
+            unityDesign = std::abs(gain) < unityGainDB;
+            if (unityDesign)
+            {
+                coeffs.b0 = 1.0;
+                coeffs.b1 = coeffs.a1;
+                coeffs.b2 = coeffs.a2;
+            }
+
+            currentCoeffs = coeffs;
+            if constexpr (hasTimeParallel)
+                blockBiquad.setCoeffs(coeffs);
+            return Topology::fromBiquad(coeffs);
+        }
+    }
+
+    bool smoothersActive() const
+    {
+        return smoothedFrequency.isSmoothing() ||
+               smoothedGainDB.isSmoothing() ||
+               smoothedQ.isSmoothing();
+    }
+
+    /**
+     * Jump the smoothers one control interval ahead, design for that point and
+     * ramp towards it.
+     *
+     * Stability guard: the ramp only runs if the target is stable and every
+     * point on the way is too. For DF1/DF2T (stability triangle) and the
+     * lattice the stable set is convex, so stable ends are enough. For the SVF
+     * it isn't, and each step is checked; if one fails, the coefficients step
+     * straight to the target instead. An unstable target (never produced by
+     * the designs here) holds the current coefficients for the interval.
+     */
+    void beginRamp()
+    {
+        lastFrequency = smoothedFrequency.skip(controlInterval);
+        lastGainDB = smoothedGainDB.skip(controlInterval);
+        lastQ = smoothedQ.skip(controlInterval);
+
+        const auto target = designParams(lastFrequency, lastGainDB, lastQ);
+
+        if (! Topology::isStable(target))
+        {
+            biquad.startRamp(biquad.getParams(), controlInterval);
+            return;
+        }
+
+        biquad.startRamp(target, controlInterval);
+
+        if constexpr (! Topology::convexStability)
+        {
+            for (int step = 1; step < controlInterval; ++step)
+            {
+                if (! Topology::isStable(biquad.getRampPoint(step)))
+                {
+                    biquad.setParams(target);
+                    biquad.startRamp(target, controlInterval);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Keep getCoeffs() on the ramp for the direct forms (Cascade's skewed path reads it).
+    void syncRampedCoeffs()
+    {
+        if constexpr (Topology::directForm)
+        {
+            const auto& p = biquad.getParams();
+            currentCoeffs = { p[0], p[1], p[2], p[3], p[4] };
+        }
+    }
+
+    /**
+     * The smoothing path with a control interval: each interval's samples run
+     * through BiquadSIMD::processRamp in one go, and whatever is left of the
+     * block once the glide ends goes to the steady kernel.
+     */
+    void processControlRate(SampleType* const* channelData, int numChannels, int numSamples)
+    {
+        for (int i = 0; i < numSamples;)
+        {
+            if (! biquad.isRamping())
+            {
+                if (! smoothersActive())
+                {
+                    std::array<SampleType*, Biquad<SampleType, Topology>::maxChannels> rest{};
+                    numChannels = std::min(numChannels, Biquad<SampleType, Topology>::maxChannels);
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        rest[static_cast<size_t>(ch)] = channelData[ch] + i;
+
+                    processSteady(rest.data(), numChannels, numSamples - i);
+                    return;
+                }
+
+                beginRamp();
+            }
+
+            const int length = std::min(numSamples - i, biquad.getRampRemaining());
+            biquad.processRamp(channelData, numChannels, i, length);
+            syncRampedCoeffs();
+            i += length;
+        }
     }
 
     // The underlying SIMD biquad filter
-    Biquad biquad;
+    Biquad<SampleType, Topology> biquad;
+
+    // Time-parallel kernel for steady blocks (shares biquad's state; only used for float DF2T)
+    BiquadBlockSIMD blockBiquad;
+    BiquadKernel kernel = BiquadKernel::Lanewise;
+    int controlInterval = 1;
+
+    // Optional precomputed designs (shared, read-only)
+    std::shared_ptr<const CoeffTable> coeffTable;
+    DesignMath designMath = DesignMath::Exact;
+    DesignMethod designMethod = DesignMethod::Bilinear;
+
+    // Skip paths
+    bool unityDesign = false;
+    bool fastPathsEnabled = true;
+    FastPathCounters counters;
 
     // Smoothed parameter values
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedFrequency;
@@ -273,6 +653,7 @@ private:
     float lastFrequency = 1000.0f;
     float lastGainDB = 0.0f;
     float lastQ = 0.707f;
+    BiquadCoeffs currentCoeffs { 1.0, 0.0, 0.0, 0.0, 0.0 };
 
     // Filter configuration
     FilterType filterType = FilterType::Peaking;
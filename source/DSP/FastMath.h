@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef BIQUAD3_FASTMATH_H
+#define BIQUAD3_FASTMATH_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <numbers>
+
+/**
+ * Polynomial stand-ins for the libm calls in coefficient design
+ * (Qcalc::calculateFast). The coefficients are minimax fits for relative
+ * error, found with a Remez exchange in long double; the bounds below are
+ * the fits' own, checked in double by scripts/FastMathCheck.cpp.
+ *
+ * Everything is a handful of multiply-adds with no calls, tables or
+ * branches on the data, so it inlines into the design code.
+ */
+namespace FastMath
+{
+    /**
+     * 2^x. Round-to-nearest splits x into n + f with |f| <= 1/2; 2^f is a
+     * degree 6 minimax polynomial, 2^n goes straight into the exponent bits.
+     * Relative error < 2e-9. x is clamped to +/-1000.
+     */
+    inline double exp2(double x) noexcept
+    {
+        // Adding and subtracting 1.5 * 2^52 rounds to an integer.
+        constexpr double roundingShift = 6755399441055744.0;
+
+        x = std::clamp(x, -1000.0, 1000.0);
+        const double n = (x + roundingShift) - roundingShift;
+        const double f = x - n;
+
+        double p = 1.53458120031498599982e-04;
+        p = p * f + 1.33999312193385039110e-03;
+        p = p * f + 9.61848895711411980741e-03;
+        p = p * f + 5.55032877696473453207e-02;
+        p = p * f + 2.40226468906340968255e-01;
+        p = p * f + 6.93147205737268075180e-01;
+        p = p * f + 1.00000000055416646207e+00;
+
+        const auto exponent = static_cast<std::uint64_t>(static_cast<std::int64_t>(n) + 1023) << 52;
+        return p * std::bit_cast<double>(exponent);
+    }
+
+    /**
+     * RBJ's A = 10^(gainDB / 40), relative error < 2e-9.
+     */
+    inline double dbToA(double gainDB) noexcept
+    {
+        return exp2(gainDB * (std::numbers::ln10_v<double> / (40.0 * std::numbers::ln2_v<double>)));
+    }
+
+    /**
+     * sin(x) and cos(x) for x in [0, pi/2]. Past pi/4 the two swap roles on
+     * pi/2 - x, so both polynomials only cover [0, pi/4]: sin(x) as
+     * x * P(x^2) (degree 9, relative error < 5e-12, also for tiny x) and
+     * cos(x) as Q(x^2) (degree 8, relative error < 6e-11).
+     */
+    inline void sinCos(double x, double& sinX, double& cosX) noexcept
+    {
+        const bool upper = x > 0.25 * std::numbers::pi_v<double>;
+        const double r = upper ? 0.5 * std::numbers::pi_v<double> - x : x;
+        const double t = r * r;
+
+        double s = 2.71715281053941230017e-06;
+        s = s * t - 1.98391783558798948787e-04;
+        s = s * t + 8.33332869015204192161e-03;
+        s = s * t - 1.66666666304461788995e-01;
+        s = s * t + 9.99999999995450351582e-01;
+        s *= r;
+
+        double c = 2.43726791771966239344e-05;
+        c = c * t - 1.38865291471453549022e-03;
+        c = c * t + 4.16666132334736204640e-02;
+        c = c * t - 4.99999995715568576319e-01;
+        c = c * t + 9.99999999943937321791e-01;
+
+        sinX = upper ? c : s;
+        cosX = upper ? s : c;
+    }
+}
+
+#endif // BIQUAD3_FASTMATH_H
@@ -0,0 +1,737 @@
+#pragma once
+
+#ifndef BIQUAD3_LINEARPHASE_H
+#define BIQUAD3_LINEARPHASE_H
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+#include "xsimd/include/xsimd/xsimd.hpp"
+#include "BiquadKernels.h"
+#include "Interpolator.h"
+#include "Qcalc.h"
+#include "RealFFT.h"
+
+/**
+ * Linear-phase alternative to Cascade for mastering: the magnitude of the
+ * bands (|H| as the response curve draws it) with no phase shift, at the
+ * cost of latency. Bands left at 0 dB (the default) are left out.
+ *
+ * The filter is designed by frequency sampling: |H| on a grid four times
+ * finer than the filter, inverse FFT to a zero-phase impulse, then firLength
+ * taps of it around the centre under a Kaiser window. It runs as uniformly
+ * partitioned overlap-save convolution: the filter is cut into partitions of
+ * partitionSize taps, each held as a spectrum, and every partitionSize input
+ * samples cost one forward FFT, one spectral multiply-add per partition
+ * against a delay line of past input spectra, and one inverse FFT. The
+ * multiply-adds run over bins in SIMD vectors, one channel at a time.
+ *
+ * Designs are made by a LinearPhaseDesigner, once per settings change, on a
+ * thread that sleeps until a setting changes or the mode is enabled. Each
+ * LinearPhaseEQ attached to it (one per precision in the plugin) only cuts
+ * the taps into its partition spectra. Finished filters are handed over
+ * through a few preallocated slots with atomic states, so the audio thread
+ * never waits or allocates; when a new one arrives it's run alongside the
+ * old one for fadePartitions partitions and crossfaded in. Settings that
+ * change while a design runs are picked up by the next one.
+ *
+ * The output is delayed by firLength / 2 (the centre tap) plus one partition
+ * (input is collected a partition at a time), reported by getLatencySamples().
+ * Both scale with the sample rate, so they're the same in time at any rate:
+ * 8192 taps at 44.1 or 48 kHz, about 96 ms of latency at 48 kHz.
+ */
+class LinearPhaseDesigner {
+public:
+    static constexpr int maxBands = maxCascadeBands;
+
+    /**
+     * Something that runs the designs. loadDesign() is called on the design
+     * thread with the taps of each new design, or from start() with
+     * `immediate` set while the audio thread is stopped.
+     */
+    struct Target
+    {
+        virtual ~Target() = default;
+
+        /** @return false if there was no free slot to take it; it's offered again later */
+        virtual bool loadDesign(const std::vector<double>& taps, std::uint64_t generation, bool immediate) = 0;
+    };
+
+    LinearPhaseDesigner() : worker(*this) {}
+
+    ~LinearPhaseDesigner()
+    {
+        worker.stopThread(1000);
+    }
+
+    /**
+     * Attach or detach an EQ. Stops the design thread; prepare() and start()
+     * again before using the ones left.
+     */
+    void addTarget(Target& target)
+    {
+        worker.stopThread(1000);
+        targets.push_back(&target);
+    }
+
+    void removeTarget(Target& target)
+    {
+        worker.stopThread(1000);
+        targets.erase(std::remove(targets.begin(), targets.end(), &target), targets.end());
+    }
+
+    /**
+     * Stop the design thread and allocate for the rate. Prepare the targets
+     * after this (they take their sizes from here), then start().
+     */
+    void prepare(double newSampleRate)
+    {
+        worker.stopThread(1000);
+
+        sampleRate = newSampleRate;
+
+        int scale = 1;
+        while (sampleRate / scale > 64000.0)
+            scale *= 2;
+
+        firLength = 8192 * scale;
+        partitionSize = 512 * scale;
+
+        designFFT.prepare(log2(designOversampling * firLength));
+
+        const auto designBins = static_cast<size_t>(designFFT.getNumBins());
+        designRe.assign(designBins, 0.0);
+        designIm.assign(designBins, 0.0);
+        impulse.assign(static_cast<size_t>(designFFT.getSize()), 0.0);
+        taps.assign(static_cast<size_t>(firLength), 0.0);
+    }
+
+    /**
+     * Design the current settings into every target straight away (they
+     * switch to it without a fade) and start the design thread.
+     */
+    void start()
+    {
+        std::array<BiquadCoeffs, maxBands> coeffs;
+        designed = readSettings(coeffs);
+        designTaps(coeffs);
+        for (auto* target : targets)
+            target->loadDesign(taps, designed, true);
+
+        worker.startThread();
+    }
+
+    /**
+     * Set one band. Allocation-free; call from any thread. While enabled a
+     * change wakes the design thread, which takes a short lock.
+     */
+    void setBand(int index, float frequency, float gainDB, float q, FilterType type) noexcept
+    {
+        auto& band = bands[static_cast<size_t>(index)];
+        if (band.frequency.load() == frequency && band.gainDB.load() == gainDB
+            && band.q.load() == q && band.type.load() == static_cast<int>(type))
+            return;
+
+        band.frequency.store(frequency);
+        band.gainDB.store(gainDB);
+        band.q.store(q);
+        band.type.store(static_cast<int>(type));
+        settingsChanged();
+    }
+
+    void setQMode(QMode mode) noexcept
+    {
+        if (qMode.exchange(static_cast<int>(mode)) != static_cast<int>(mode))
+            settingsChanged();
+    }
+
+    /** Bilinear or matched bands, as Engine::setDesignMethod. */
+    void setDesignMethod(DesignMethod method) noexcept
+    {
+        if (designMethod.exchange(static_cast<int>(method)) != static_cast<int>(method))
+            settingsChanged();
+    }
+
+    /**
+     * The design thread only works while enabled, so automation in the IIR
+     * mode costs nothing here. Enabling it designs whatever changed since.
+     */
+    void setEnabled(bool shouldBeEnabled) noexcept
+    {
+        if (! enabled.exchange(shouldBeEnabled, std::memory_order_acq_rel) && shouldBeEnabled)
+            worker.notify();
+    }
+
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /** The generation of the latest settings, bumped on every change. */
+    std::uint64_t getRequestedGeneration() const noexcept { return requested.load(std::memory_order_acquire); }
+
+    double getSampleRate() const { return sampleRate; }
+    int getFilterLength() const { return firLength; }
+    int getPartitionSize() const { return partitionSize; }
+
+private:
+    // Settings as written by setBand(), read by the design thread.
+    struct BandSettings
+    {
+        std::atomic<float> frequency { 1000.0f };
+        std::atomic<float> gainDB { 0.0f };
+        std::atomic<float> q { 0.707f };
+        std::atomic<int> type { static_cast<int>(FilterType::Peaking) };
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(LinearPhaseDesigner& designer) : juce::Thread("Linear phase design"), owner(designer) {}
+
+        // Sleeps until notified; only polls while a target is out of free
+        // slots, which the audio thread frees without telling anyone.
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                const bool done = ! owner.enabled.load(std::memory_order_acquire) || owner.designLatest();
+                wait(done ? -1 : retryIntervalMs);
+            }
+        }
+
+    private:
+        LinearPhaseDesigner& owner;
+    };
+
+    static constexpr int designOversampling = 4;
+    static constexpr int retryIntervalMs = 10;
+    static constexpr double windowAttenuationDB = 80.0;
+
+    static int log2(int n)
+    {
+        int order = 0;
+        while ((1 << order) < n)
+            ++order;
+        return order;
+    }
+
+    void settingsChanged() noexcept
+    {
+        requested.fetch_add(1, std::memory_order_release);
+        if (enabled.load(std::memory_order_acquire))
+            worker.notify();
+    }
+
+    // ---- design thread (and start(), while it's stopped) ----
+
+    // @return false if a target couldn't take the design yet
+    bool designLatest()
+    {
+        if (requested.load(std::memory_order_acquire) == designed)
+            return true;
+
+        std::array<BiquadCoeffs, maxBands> coeffs;
+        const auto generation = readSettings(coeffs);
+        designTaps(coeffs);
+
+        bool loaded = true;
+        for (auto* target : targets)
+            loaded = target->loadDesign(taps, generation, false) && loaded;
+
+        if (loaded)
+            designed = generation;
+
+        return loaded;
+    }
+
+    static constexpr BiquadCoeffs unity { 1.0, 0.0, 0.0, 0.0, 0.0 };
+
+    static bool isUnity(const BiquadCoeffs& c)
+    {
+        return c.b0 == 1.0 && c.b1 == 0.0 && c.b2 == 0.0 && c.a1 == 0.0 && c.a2 == 0.0;
+    }
+
+    // Coefficients of the current settings, and the generation they belong to
+    // (read again if a setBand() lands in between). Bands at 0 dB are unity.
+    std::uint64_t readSettings(std::array<BiquadCoeffs, maxBands>& coeffs) const
+    {
+        std::array<double, maxBands> frequency, gainDB, q, b0, b1, b2, a1, a2;
+        std::array<FilterType, maxBands> types;
+        std::uint64_t generation;
+        QMode mode;
+        DesignMethod method;
+
+        do
+        {
+            generation = requested.load(std::memory_order_acquire);
+            for (size_t i = 0; i < maxBands; ++i)
+            {
+                frequency[i] = bands[i].frequency.load();
+                gainDB[i] = bands[i].gainDB.load();
+                q[i] = bands[i].q.load();
+                types[i] = static_cast<FilterType>(bands[i].type.load());
+            }
+            mode = static_cast<QMode>(qMode.load());
+            method = static_cast<DesignMethod>(designMethod.load());
+        } while (generation != requested.load(std::memory_order_acquire));
+
+        if (method == DesignMethod::Matched)
+        {
+            for (size_t i = 0; i < maxBands; ++i)
+                coeffs[i] = Qcalc::calculateMatched(sampleRate, frequency[i], gainDB[i], q[i], mode, types[i]);
+        }
+        else
+        {
+            Qcalc::calculateBatch<double>(sampleRate, frequency, gainDB, q, types, mode, { b0, b1, b2, a1, a2 });
+            for (size_t i = 0; i < maxBands; ++i)
+                coeffs[i] = { b0[i], b1[i], b2[i], a1[i], a2[i] };
+        }
+
+        // Exactly unity, so designTaps() can leave them out.
+        for (size_t i = 0; i < maxBands; ++i)
+            if (gainDB[i] == 0.0)
+                coeffs[i] = unity;
+
+        return generation;
+    }
+
+    void designTaps(const std::array<BiquadCoeffs, maxBands>& coeffs)
+    {
+        // Zero-phase impulse of |H|: real, even, centred on sample 0.
+        const int designSize = designFFT.getSize();
+        for (int k = 0; k < designFFT.getNumBins(); ++k)
+        {
+            const double omega = 2.0 * std::numbers::pi * k / designSize;
+            double magnitudeSquared = 1.0;
+            for (const auto& c : coeffs)
+                if (! isUnity(c))
+                    magnitudeSquared *= Qcalc::magnitudeSquared(c, omega);
+
+            designRe[static_cast<size_t>(k)] = std::sqrt(magnitudeSquared);
+            designIm[static_cast<size_t>(k)] = 0.0;
+        }
+
+        designFFT.inverse(designRe.data(), designIm.data(), impulse.data());
+
+        // Tap n is the impulse at n - firLength / 2, windowed.
+        const int centre = firLength / 2;
+        const double beta = Kaiser::beta(windowAttenuationDB);
+
+        for (int n = 0; n < firLength; ++n)
+        {
+            const int t = n - centre;
+            taps[static_cast<size_t>(n)] = impulse[static_cast<size_t>((t + designSize) % designSize)]
+                                         * Kaiser::window(static_cast<double>(t) / centre, beta);
+        }
+    }
+
+    double sampleRate = 44100.0;
+    int firLength = 0;
+    int partitionSize = 0;
+
+    // Settings and their generation, bumped on every change.
+    std::array<BandSettings, maxBands> bands;
+    std::atomic<int> qMode { static_cast<int>(QMode::Constant_Q) };
+    std::atomic<int> designMethod { static_cast<int>(DesignMethod::Bilinear) };
+    std::atomic<std::uint64_t> requested { 1 };
+    std::atomic<bool> enabled { false };
+
+    // Only changed while the design thread is stopped.
+    std::vector<Target*> targets;
+
+    // Design thread
+    RealFFT<double> designFFT;
+    std::vector<double> designRe, designIm, impulse, taps;
+    std::uint64_t designed = 0;
+
+    Worker worker;
+};
+
+/**
+ * The running half of the linear-phase EQ, in one precision: partition
+ * spectra of the designer's filters and the convolution. Designs and their
+ * settings come from the LinearPhaseDesigner passed in, which must outlive it.
+ */
+template <typename SampleType>
+class LinearPhaseEQ : private LinearPhaseDesigner::Target {
+public:
+    using Batch = xsimd::batch<SampleType>;
+
+    static constexpr int maxBands = LinearPhaseDesigner::maxBands;
+    static constexpr int maxChannels = maxKernelChannels;
+    static constexpr int fadePartitions = 2;
+
+    explicit LinearPhaseEQ(LinearPhaseDesigner& designerToUse) : designer(designerToUse)
+    {
+        designer.addTarget(*this);
+    }
+
+    ~LinearPhaseEQ() override
+    {
+        designer.removeTarget(*this);
+    }
+
+    /**
+     * Allocate for the channel count, at the rate the designer was last
+     * prepared for. Call between LinearPhaseDesigner::prepare() and start();
+     * until then it outputs silence.
+     */
+    void prepare(int numChannels)
+    {
+        numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+
+        firLength = designer.getFilterLength();
+        partitionSize = designer.getPartitionSize();
+        numPartitions = firLength / partitionSize;
+
+        constexpr int lanes = static_cast<int>(Batch::size);
+        stride = (partitionSize + 1 + lanes - 1) / lanes * lanes;
+
+        fft.prepare(log2(2 * partitionSize));
+
+        const auto spectraSize = static_cast<size_t>(numPartitions * stride);
+        for (auto& slot : slots)
+        {
+            slot.re.assign(spectraSize, SampleType(0));
+            slot.im.assign(spectraSize, SampleType(0));
+            slot.state.store(Free);
+            slot.generation.store(0);
+        }
+
+        const auto channels = static_cast<size_t>(numPreparedChannels);
+        frames.assign(channels * static_cast<size_t>(2 * partitionSize), SampleType(0));
+        outputs.assign(channels * static_cast<size_t>(partitionSize), SampleType(0));
+        delayRe.assign(channels * spectraSize, SampleType(0));
+        delayIm.assign(channels * spectraSize, SampleType(0));
+        accRe.assign(static_cast<size_t>(stride), SampleType(0));
+        accIm.assign(static_cast<size_t>(stride), SampleType(0));
+        scratch.assign(static_cast<size_t>(2 * partitionSize), SampleType(0));
+        fadeScratch.assign(static_cast<size_t>(2 * partitionSize), SampleType(0));
+        partitionScratch.assign(static_cast<size_t>(2 * partitionSize), SampleType(0));
+
+        slots[0].state.store(InUse);
+        active = 0;
+        previous = -1;
+        loaded = 0;
+
+        reset();
+    }
+
+    /**
+     * Whether the processor runs this EQ rather than its IIR chain. Audio
+     * thread; the designer has its own switch for the design thread.
+     */
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+    bool isEnabled() const noexcept { return enabled; }
+
+    /**
+     * Clear the signal history. A newer filter that's ready is switched to
+     * without a fade, since there's nothing to fade from.
+     */
+    void reset() noexcept
+    {
+        std::fill(frames.begin(), frames.end(), SampleType(0));
+        std::fill(outputs.begin(), outputs.end(), SampleType(0));
+        std::fill(delayRe.begin(), delayRe.end(), SampleType(0));
+        std::fill(delayIm.begin(), delayIm.end(), SampleType(0));
+        fill = 0;
+        head = 0;
+
+        if (previous >= 0)
+            release(previous);
+        previous = -1;
+
+        if (const int newest = claimNewest(); newest >= 0)
+        {
+            release(active);
+            active = newest;
+        }
+    }
+
+    int getLatencySamples() const { return firLength / 2 + partitionSize; }
+    int getFilterLength() const { return firLength; }
+    int getPartitionSize() const { return partitionSize; }
+
+    /**
+     * True once the running filter is the design of the latest settings and
+     * no crossfade is in progress. Audio thread only.
+     */
+    bool isUpToDate() const noexcept
+    {
+        return previous < 0 && slots[static_cast<size_t>(active)].generation.load() == designer.getRequestedGeneration();
+    }
+
+    /**
+     * Filter a block in place, any size; channels past the prepared count are
+     * left alone.
+     */
+    void process(juce::AudioBuffer<SampleType>& buffer) noexcept
+    {
+        process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+
+    /** The same on raw channel pointers. */
+    void process(SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        numChannels = std::min(numChannels, numPreparedChannels);
+
+        for (int position = 0; position < numSamples;)
+        {
+            const int count = std::min(numSamples - position, partitionSize - fill);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                SampleType* x = channels[ch] + position;
+                std::copy(x, x + count, frame(ch) + partitionSize + fill);
+                std::copy(output(ch) + fill, output(ch) + fill + count, x);
+            }
+
+            fill += count;
+            position += count;
+
+            if (fill == partitionSize)
+            {
+                processPartition(numChannels);
+                fill = 0;
+            }
+        }
+    }
+
+private:
+    enum SlotState { Free, Writing, Ready, InUse };
+
+    // One filter's partition spectra. The audio thread owns InUse slots (the
+    // running one and, while fading, the one before); the design thread owns
+    // Writing ones. Ready slots are claimed by the audio thread, or freed by
+    // the design thread once a newer design is ready.
+    struct Slot
+    {
+        std::vector<SampleType> re, im;
+        std::atomic<int> state { Free };
+        std::atomic<std::uint64_t> generation { 0 };
+    };
+
+    static constexpr int numSlots = 4;
+
+    static int log2(int n)
+    {
+        int order = 0;
+        while ((1 << order) < n)
+            ++order;
+        return order;
+    }
+
+    SampleType* frame(int ch) noexcept { return frames.data() + ch * 2 * partitionSize; }
+    SampleType* output(int ch) noexcept { return outputs.data() + ch * partitionSize; }
+
+    // ---- audio thread ----
+
+    void processPartition(int numChannels) noexcept
+    {
+        if (previous < 0)
+            if (const int newest = claimNewest(); newest >= 0)
+            {
+                previous = active;
+                active = newest;
+                fadePosition = 0;
+            }
+
+        head = (head == 0 ? numPartitions : head) - 1;
+        const int fadeLength = fadePartitions * partitionSize;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            SampleType* time = frame(ch);
+            const auto spectrum = static_cast<size_t>((ch * numPartitions + head) * stride);
+            fft.forward(time, delayRe.data() + spectrum, delayIm.data() + spectrum);
+            std::copy(time + partitionSize, time + 2 * partitionSize, time);
+
+            // Overlap-save: the second half of the circular convolution is the linear one.
+            SampleType* out = output(ch);
+            convolve(ch, slots[static_cast<size_t>(active)], scratch.data());
+            std::copy(scratch.begin() + partitionSize, scratch.end(), out);
+
+            if (previous >= 0)
+            {
+                convolve(ch, slots[static_cast<size_t>(previous)], fadeScratch.data());
+                const SampleType* old = fadeScratch.data() + partitionSize;
+                const SampleType step = SampleType(1) / static_cast<SampleType>(fadeLength);
+
+                for (int i = 0; i < partitionSize; ++i)
+                {
+                    const auto gain = static_cast<SampleType>(fadePosition + i + 1) * step;
+                    out[i] = old[i] + gain * (out[i] - old[i]);
+                }
+            }
+        }
+
+        if (previous >= 0)
+        {
+            fadePosition += partitionSize;
+            if (fadePosition >= fadeLength)
+            {
+                release(previous);
+                previous = -1;
+            }
+        }
+    }
+
+    // Sum of every partition's spectrum times the input spectrum that many
+    // partitions back, then back to time (2 * partitionSize samples).
+    void convolve(int ch, const Slot& slot, SampleType* time) noexcept
+    {
+        constexpr int lanes = static_cast<int>(Batch::size);
+        const SampleType* xRe = delayRe.data() + ch * numPartitions * stride;
+        const SampleType* xIm = delayIm.data() + ch * numPartitions * stride;
+
+        for (int k = 0; k < stride; k += lanes)
+        {
+            Batch sumRe(SampleType(0)), sumIm(SampleType(0));
+            for (int p = 0, x = head; p < numPartitions; ++p, x = (x + 1 == numPartitions ? 0 : x + 1))
+            {
+                const Batch aRe = Batch::load_unaligned(xRe + x * stride + k);
+                const Batch aIm = Batch::load_unaligned(xIm + x * stride + k);
+                const Batch hRe = Batch::load_unaligned(slot.re.data() + p * stride + k);
+                const Batch hIm = Batch::load_unaligned(slot.im.data() + p * stride + k);
+
+                sumRe = xsimd::fnma(aIm, hIm, xsimd::fma(aRe, hRe, sumRe));
+                sumIm = xsimd::fma(aIm, hRe, xsimd::fma(aRe, hIm, sumIm));
+            }
+
+            sumRe.store_unaligned(accRe.data() + k);
+            sumIm.store_unaligned(accIm.data() + k);
+        }
+
+        fft.inverse(accRe.data(), accIm.data(), time);
+    }
+
+    // Claim the newest Ready slot if it's newer than the running filter; -1 if none.
+    int claimNewest() noexcept
+    {
+        int newest = -1;
+        std::uint64_t newestGeneration = slots[static_cast<size_t>(active)].generation.load();
+
+        for (int s = 0; s < numSlots; ++s)
+        {
+            const auto& slot = slots[static_cast<size_t>(s)];
+            if (slot.state.load(std::memory_order_acquire) == Ready && slot.generation.load() > newestGeneration)
+            {
+                newest = s;
+                newestGeneration = slot.generation.load();
+            }
+        }
+
+        int expected = Ready;
+        if (newest < 0 || ! slots[static_cast<size_t>(newest)].state.compare_exchange_strong(expected, InUse, std::memory_order_acq_rel))
+            return -1;
+
+        return newest;
+    }
+
+    void release(int s) noexcept
+    {
+        slots[static_cast<size_t>(s)].state.store(Free, std::memory_order_release);
+    }
+
+    // ---- design thread (and LinearPhaseDesigner::start(), with `immediate`) ----
+
+    bool loadDesign(const std::vector<double>& taps, std::uint64_t generation, bool immediate) override
+    {
+        if (immediate)
+        {
+            // The audio thread is stopped: straight into the running slot.
+            for (auto& slot : slots)
+                slot.state.store(Free);
+
+            fillSlot(taps, slots[0]);
+            slots[0].generation.store(generation);
+            slots[0].state.store(InUse);
+            active = 0;
+            previous = -1;
+            loaded = generation;
+            reset();
+            return true;
+        }
+
+        if (generation <= loaded)
+            return true;
+
+        Slot* slot = nullptr;
+        for (auto& candidate : slots)
+        {
+            int expected = Free;
+            if (candidate.state.compare_exchange_strong(expected, Writing, std::memory_order_acquire))
+            {
+                slot = &candidate;
+                break;
+            }
+        }
+
+        if (slot == nullptr)
+            return false;
+
+        fillSlot(taps, *slot);
+        slot->generation.store(generation);
+        slot->state.store(Ready, std::memory_order_release);
+
+        // Only the newest Ready design is worth keeping.
+        for (auto& other : slots)
+        {
+            int expected = Ready;
+            if (&other != slot && other.generation.load() < generation)
+                other.state.compare_exchange_strong(expected, Free, std::memory_order_acq_rel);
+        }
+
+        loaded = generation;
+        return true;
+    }
+
+    // Each partition of the taps, zero-padded to the FFT size, as a spectrum.
+    void fillSlot(const std::vector<double>& taps, Slot& slot)
+    {
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            for (int i = 0; i < partitionSize; ++i)
+                partitionScratch[static_cast<size_t>(i)] = static_cast<SampleType>(taps[static_cast<size_t>(p * partitionSize + i)]);
+            std::fill(partitionScratch.begin() + partitionSize, partitionScratch.end(), SampleType(0));
+
+            fft.forward(partitionScratch.data(), slot.re.data() + p * stride, slot.im.data() + p * stride);
+        }
+    }
+
+    // Shared by both threads; it only reads its tables.
+    RealFFT<SampleType> fft;
+
+    LinearPhaseDesigner& designer;
+    bool enabled = false;
+
+    int numPreparedChannels = 0;
+    int firLength = 0;
+    int partitionSize = 0;
+    int numPartitions = 0;
+    int stride = 0; // floats per partition spectrum: the bins, rounded up to whole vectors
+
+    std::array<Slot, numSlots> slots;
+
+    // Audio thread: slots in use, the fade, and per channel the last two
+    // partitions of input, the partition of output being played and the
+    // delay line of input spectra (newest at `head`).
+    int active = 0;
+    int previous = -1;
+    int fadePosition = 0;
+    int fill = 0;
+    int head = 0;
+    std::vector<SampleType> frames, outputs;
+    std::vector<SampleType> delayRe, delayIm;
+    std::vector<SampleType> accRe, accIm, scratch, fadeScratch;
+
+    // Design thread: the newest design taken, and where its partitions are cut.
+    std::vector<SampleType> partitionScratch;
+    std::uint64_t loaded = 0;
+};
+
+#endif
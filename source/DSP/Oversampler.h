@@ -0,0 +1,591 @@
+#pragma once
+
+#ifndef BIQUAD3_OVERSAMPLER_H
+#define BIQUAD3_OVERSAMPLER_H
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "xsimd/include/xsimd/xsimd.hpp"
+#include "BiquadKernels.h"
+#include "Interpolator.h"
+
+/**
+ * Half-band filter shapes for the oversampling stages.
+ */
+enum class OversamplingPhase
+{
+    Linear,  // Kaiser-windowed FIR half-bands: constant group delay, more latency
+    Minimum  // polyphase IIR allpass half-bands: a few samples of latency, phase shift near the top
+};
+
+/**
+ * Half-band designs, in double. Both kinds are built to the same spec: pass
+ * 0.45 of the base rate, reject attenuationDB from 0.55 of it. Each later
+ * stage only has to keep its images off that band, so its transition is
+ * wider and it gets far fewer taps/allpasses than the first one.
+ */
+namespace HalfBand
+{
+    inline constexpr double attenuationDB = 100.0;
+    inline constexpr int maxFirHalfTaps = 48; // unique taps of the odd phase
+    inline constexpr int maxIirCoeffs = 16;
+
+    /**
+     * Transition half-width of stage `stage` (0 = the first 2x) as a fraction
+     * of its output rate; the passband edge is at 0.25 - transition.
+     */
+    inline double transition(int stage)
+    {
+        return 0.25 - 0.225 / static_cast<double>(1 << stage);
+    }
+
+    // Largest stopband gain of the FIR half-band below, on a grid from 0.25 + transition to 0.5.
+    inline double firStopbandPeak(const double* taps, int halfTaps, double transition)
+    {
+        constexpr int gridSize = 512;
+
+        double peak = 0.0;
+        for (int j = 0; j <= gridSize; ++j)
+        {
+            const double w = 2.0 * std::numbers::pi * (0.25 + transition + (0.25 - transition) * j / gridSize);
+
+            // Zero phase about the centre tap: 1/2 + sum of the symmetric odd pairs.
+            double response = 0.5;
+            for (int i = 0; i < halfTaps; ++i)
+                response += 2.0 * taps[i] * std::cos(w * (2 * (halfTaps - i) - 1));
+
+            peak = std::max(peak, std::abs(response));
+        }
+
+        return peak;
+    }
+
+    /**
+     * Kaiser-windowed half-band FIR, length 4K - 1. Every other tap is zero
+     * bar the centre (1/2), so only the 2K taps of the odd phase are stored:
+     * taps[i] = h[2i - (2K - 1)], symmetric, summing to exactly 1/2.
+     * Kaiser's length estimate runs short for the small later stages, so K
+     * grows from there until the stopband actually meets the attenuation.
+     *
+     * @return K, the number of unique taps
+     */
+    inline int designFIR(double transition, double* taps)
+    {
+        const double width = 2.0 * transition;
+        const double length = (attenuationDB - 7.95) / (14.36 * width) + 1.0;
+        const double beta = Kaiser::beta(attenuationDB);
+        const double limit = std::pow(10.0, -attenuationDB / 20.0);
+
+        int K = std::clamp(static_cast<int>(std::ceil((length + 1.0) / 4.0)), 1, maxFirHalfTaps);
+        for (;; ++K)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < 2 * K; ++i)
+            {
+                const int k = 2 * i - (2 * K - 1);
+                taps[i] = std::sin(std::numbers::pi * k / 2.0) / (std::numbers::pi * k) * Kaiser::window(k / (2.0 * K), beta);
+                sum += taps[i];
+            }
+
+            for (int i = 0; i < 2 * K; ++i)
+                taps[i] *= 0.5 / sum;
+
+            if (K == maxFirHalfTaps || firStopbandPeak(taps, K, transition) <= limit)
+                return K;
+        }
+    }
+
+    /**
+     * Polyphase IIR half-band H(z) = (A0(z^2) + z^-1 A1(z^2)) / 2, the
+     * elliptic design from Laurent de Soras' HIIR library. A0 and A1 are
+     * chains of first-order allpasses (a + z^-1) / (1 + a z^-1); coefficient
+     * 0, 2, 4 ... belongs to A0 and 1, 3, 5 ... to A1. The number of
+     * coefficients follows from the attenuation and transition.
+     *
+     * @return the number of coefficients
+     */
+    inline int designIIR(double transition, double* coeffs)
+    {
+        const double pi = std::numbers::pi;
+
+        double k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+        k *= k;
+        const double kksqrt = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        const double e4 = e * e * e * e;
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const double attenuation = std::pow(10.0, -attenuationDB / 10.0);
+        const double a = attenuation / (1.0 - attenuation);
+        const int wantedOrder = static_cast<int>(std::ceil(std::log(a * a / 16.0) / std::log(q)));
+        const int numCoeffs = std::clamp((wantedOrder | 1) / 2, 1, maxIirCoeffs);
+        const int order = 2 * numCoeffs + 1;
+
+        for (int index = 0; index < numCoeffs; ++index)
+        {
+            const int c = index + 1;
+
+            double num = 0.0, term = 0.0;
+            for (int i = 0, sign = 1; i == 0 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = std::pow(q, i * (i + 1)) * std::sin((2 * i + 1) * c * pi / order) * sign;
+                num += term;
+            }
+
+            double den = 0.0;
+            for (int i = 1, sign = -1; i == 1 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = std::pow(q, i * i) * std::cos(2 * i * c * pi / order) * sign;
+                den += term;
+            }
+
+            const double ww = num * std::pow(q, 0.25) / (den + 0.5);
+            const double wwsq = ww * ww;
+            const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+            coeffs[index] = (1.0 - x) / (1.0 + x);
+        }
+
+        return numCoeffs;
+    }
+}
+
+/**
+ * 2x to 16x oversampling around a callable that runs at the high rate,
+ * as a chain of 2x half-band stages (OversamplingPhase picks FIR or IIR).
+ *
+ * Channels are packed into SIMD lanes the same way as BiquadSIMD: channel c
+ * lives in lane c % lanes of group c / lanes. Each stage is polyphase, so
+ * it only computes what survives: upsampling filters the base-rate samples
+ * once per phase instead of filtering zero-stuffed input, downsampling only
+ * the kept outputs. The FIR also folds its symmetric taps, so a stage costs
+ * K multiplies per output pair.
+ *
+ * Blocks go through in pieces of at most chunkSize base-rate samples, so the
+ * buffers don't depend on the host's block size; prepare() allocates them all
+ * for maxStages and setStages() only picks, so switching the factor while
+ * playing never allocates.
+ *
+ * Latency: each stage delays by a fixed number of high-rate samples, which
+ * doesn't generally add up to whole base-rate samples. A short delay at the
+ * top rate pads it out, so getLatencySamples() is exact for the FIR and the
+ * low-frequency group delay (to within half a top-rate sample) for the IIR.
+ *
+ * SampleType is float or double; the designs are in double either way.
+ */
+template <typename SampleType>
+class Oversampler {
+public:
+    using Batch = xsimd::batch<SampleType>;
+    using Kernels = BiquadKernels<xsimd::default_arch>;
+
+    static constexpr int lanes = static_cast<int>(Batch::size);
+    static constexpr int maxChannels = maxKernelChannels;
+    static constexpr int maxGroups = (maxChannels + lanes - 1) / lanes;
+    static constexpr int maxStages = 4; // 16x
+    static constexpr int maxFactor = 1 << maxStages;
+    static constexpr int chunkSize = 256;
+
+    Oversampler()
+    {
+        for (int s = 0; s < maxStages; ++s)
+        {
+            double taps[2 * HalfBand::maxFirHalfTaps], coeffs[HalfBand::maxIirCoeffs];
+
+            auto& design = designs[static_cast<size_t>(s)];
+            design.halfTaps = HalfBand::designFIR(HalfBand::transition(s), taps);
+            design.numCoeffs = HalfBand::designIIR(HalfBand::transition(s), coeffs);
+
+            for (int i = 0; i < design.halfTaps; ++i)
+                design.taps[static_cast<size_t>(i)] = static_cast<SampleType>(taps[i]);
+            for (int i = 0; i < design.numCoeffs; ++i)
+                design.coeffs[static_cast<size_t>(i)] = static_cast<SampleType>(coeffs[i]);
+
+            // DC group delay of each branch, in samples at the stage's input rate.
+            design.branchDelay[0] = design.branchDelay[1] = 0.0;
+            for (int i = 0; i < design.numCoeffs; ++i)
+                design.branchDelay[i % 2] += (1.0 - coeffs[i]) / (1.0 + coeffs[i]);
+        }
+    }
+
+    /**
+     * Allocate the stage buffers and state for up to maxStages.
+     * Call from prepareToPlay().
+     *
+     * @param numChannels Channel count of the bus
+     */
+    void prepare(int numChannels)
+    {
+        numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+        numGroups = (numPreparedChannels + lanes - 1) / lanes;
+
+        for (int s = 0; s <= maxStages; ++s)
+            frames[static_cast<size_t>(s)].assign(static_cast<size_t>(numGroups * (chunkSize << s)), Batch(SampleType(0)));
+
+        states.assign(static_cast<size_t>(numGroups * maxStages), StageState{});
+        pads.assign(static_cast<size_t>(numGroups), Pad{});
+        topRate.setSize(numPreparedChannels, chunkSize * maxFactor);
+
+        setStages(numStages, phase);
+    }
+
+    /**
+     * Pick the factor (2^numStages, 0 = off) and the filter kind. Clears the
+     * state; allocation-free.
+     */
+    void setStages(int newNumStages, OversamplingPhase newPhase)
+    {
+        numStages = std::clamp(newNumStages, 0, maxStages);
+        phase = newPhase;
+        updateLatency();
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& state : states)
+            state = StageState{};
+        for (auto& pad : pads)
+            pad = Pad{};
+    }
+
+    int getNumStages() const { return numStages; }
+    int getFactor() const { return 1 << numStages; }
+    OversamplingPhase getPhase() const { return phase; }
+
+    /**
+     * Delay from input to output in base-rate samples.
+     */
+    int getLatencySamples() const { return latency; }
+
+    /**
+     * The largest getLatencySamples() of any setting, for sizing delays.
+     */
+    int getMaxLatencySamples() const
+    {
+        return std::max(getLatency(maxStages, OversamplingPhase::Linear), getLatency(maxStages, OversamplingPhase::Minimum));
+    }
+
+    /**
+     * Upsample `buffer`, run `atHighRate` on the oversampled audio and write
+     * the downsampled result back into `buffer`. With oversampling off this is
+     * just atHighRate(buffer).
+     *
+     * @param buffer Audio buffer, processed in place
+     * @param atHighRate Callable taking a juce::AudioBuffer<SampleType>&,
+     *                   getFactor() times as long, at most chunkSize * factor
+     */
+    template <typename Process>
+    void process(juce::AudioBuffer<SampleType>& buffer, Process&& atHighRate)
+    {
+        if (numStages == 0)
+        {
+            atHighRate(buffer);
+            return;
+        }
+
+        processChunks(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), atHighRate);
+    }
+
+    /**
+     * The same on raw channel pointers, for views of part of a buffer: here
+     * `atHighRate` takes (SampleType* const* channels, int numChannels,
+     * int numSamples).
+     */
+    template <typename Process>
+    void process(SampleType* const* channels, int numChannels, int numSamples, Process&& atHighRate)
+    {
+        if (numStages == 0)
+        {
+            atHighRate(channels, numChannels, numSamples);
+            return;
+        }
+
+        processChunks(channels, numChannels, numSamples, [&atHighRate](juce::AudioBuffer<SampleType>& high)
+        {
+            atHighRate(high.getArrayOfWritePointers(), high.getNumChannels(), high.getNumSamples());
+        });
+    }
+
+private:
+    // Up, atHighRate(topRate), down, a chunk at a time.
+    template <typename Process>
+    void processChunks(SampleType* const* channels, int numChannels, int numSamples, Process&& atHighRate)
+    {
+        numChannels = std::min(numChannels, numPreparedChannels);
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int length = std::min(chunkSize, numSamples - start);
+
+            // Same allocation, cut to this chunk.
+            topRate.setSize(numChannels, length << numStages, false, false, true);
+
+            for (int first = 0, g = 0; first < numChannels; first += lanes, ++g)
+                upsample(g, channels + first, std::min(lanes, numChannels - first), start, length);
+
+            atHighRate(topRate);
+
+            for (int first = 0, g = 0; first < numChannels; first += lanes, ++g)
+                downsample(g, channels + first, std::min(lanes, numChannels - first), start, length);
+        }
+    }
+
+    struct Design
+    {
+        int halfTaps = 0;
+        std::array<SampleType, HalfBand::maxFirHalfTaps> taps {};
+        int numCoeffs = 0;
+        std::array<SampleType, HalfBand::maxIirCoeffs> coeffs {};
+        double branchDelay[2] {};
+    };
+
+    // One group of channels through one stage, both directions.
+    struct StageState
+    {
+        // FIR: input history written twice so the window is always contiguous
+        // (newest first), plus the delay on the centre-tap phase.
+        std::array<Batch, 4 * HalfBand::maxFirHalfTaps> upHistory {}, downHistory {};
+        std::array<Batch, HalfBand::maxFirHalfTaps + 1> centreDelay {};
+        int upPosition = 0, downPosition = 0, centrePosition = 0;
+
+        // IIR: x[n-1] and y[n-1] of every allpass
+        std::array<Batch, HalfBand::maxIirCoeffs> upX {}, upY {}, downX {}, downY {};
+    };
+
+    // Top-rate delay that rounds the latency up to whole base-rate samples.
+    struct Pad
+    {
+        std::array<Batch, maxFactor> line {};
+        int position = 0;
+    };
+
+    // Delay of a setting in top-rate samples, up and down together.
+    double getDelay(int stages, OversamplingPhase kind) const
+    {
+        double delay = 0.0;
+        for (int s = 0; s < stages; ++s)
+        {
+            const auto& design = designs[static_cast<size_t>(s)];
+            const int scale = 1 << (stages - s - 1);
+
+            if (kind == OversamplingPhase::Linear)
+            {
+                // 2K - 1 output-rate samples each way
+                delay += 2.0 * (2 * design.halfTaps - 1) * scale;
+            }
+            else
+            {
+                // The two branches' low-frequency delay at the output rate, averaged
+                // (2 d0 for A0, 2 d1 + 1 for A1); the downsampler is one sample early.
+                const double oneWay = design.branchDelay[0] + design.branchDelay[1] + 0.5;
+                delay += (2.0 * oneWay - 1.0) * scale;
+            }
+        }
+
+        return delay;
+    }
+
+    // Rounded up to whole base-rate samples.
+    int getLatency(int stages, OversamplingPhase kind) const
+    {
+        return static_cast<int>(std::ceil(getDelay(stages, kind) / (1 << stages) - 1.0e-9));
+    }
+
+    void updateLatency()
+    {
+        const int factor = getFactor();
+        latency = getLatency(numStages, phase);
+        padLength = std::clamp(static_cast<int>(std::lround(latency * factor - getDelay(numStages, phase))), 0, maxFactor - 1);
+    }
+
+    Batch* groupFrames(int level, int group) noexcept
+    {
+        return frames[static_cast<size_t>(level)].data() + group * (chunkSize << level);
+    }
+
+    StageState& stageState(int group, int stage) noexcept
+    {
+        return states[static_cast<size_t>(group * maxStages + stage)];
+    }
+
+    void upsample(int group, SampleType* const* channels, int count, int start, int length) noexcept
+    {
+        Batch* in = groupFrames(0, group);
+        for (int i = 0; i < length; ++i)
+            in[i] = Kernels::gather(channels, count, start + i);
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            const int n = length << s;
+            if (phase == OversamplingPhase::Linear)
+                upFIR(designs[static_cast<size_t>(s)], stageState(group, s), groupFrames(s, group), n, groupFrames(s + 1, group));
+            else
+                upIIR(designs[static_cast<size_t>(s)], stageState(group, s), groupFrames(s, group), n, groupFrames(s + 1, group));
+        }
+
+        const Batch* out = groupFrames(numStages, group);
+        SampleType* const* top = topRate.getArrayOfWritePointers() + group * lanes;
+        for (int i = 0; i < (length << numStages); ++i)
+            Kernels::scatter(out[i], top, count, i);
+    }
+
+    void downsample(int group, SampleType* const* channels, int count, int start, int length) noexcept
+    {
+        Batch* in = groupFrames(numStages, group);
+        SampleType* const* top = topRate.getArrayOfWritePointers() + group * lanes;
+        Pad& pad = pads[static_cast<size_t>(group)];
+
+        for (int i = 0; i < (length << numStages); ++i)
+        {
+            const Batch x = Kernels::gather(top, count, i);
+            if (padLength == 0)
+            {
+                in[i] = x;
+                continue;
+            }
+
+            in[i] = pad.line[static_cast<size_t>(pad.position)];
+            pad.line[static_cast<size_t>(pad.position)] = x;
+            pad.position = pad.position + 1 == padLength ? 0 : pad.position + 1;
+        }
+
+        for (int s = numStages - 1; s >= 0; --s)
+        {
+            const int n = length << s;
+            if (phase == OversamplingPhase::Linear)
+                downFIR(designs[static_cast<size_t>(s)], stageState(group, s), groupFrames(s + 1, group), n, groupFrames(s, group));
+            else
+                downIIR(designs[static_cast<size_t>(s)], stageState(group, s), groupFrames(s + 1, group), n, groupFrames(s, group));
+        }
+
+        const Batch* out = groupFrames(0, group);
+        for (int i = 0; i < length; ++i)
+            Kernels::scatter(out[i], channels, count, start + i);
+    }
+
+    // Sum of taps[i] * (x[i] + x[2K - 1 - i]) over the folded window.
+    static inline Batch foldedDot(const Design& d, const Batch* window) noexcept
+    {
+        const int last = 2 * d.halfTaps - 1;
+
+        Batch acc(SampleType(0));
+        for (int i = 0; i < d.halfTaps; ++i)
+            acc = xsimd::fma(Batch(d.taps[static_cast<size_t>(i)]), window[i] + window[last - i], acc);
+
+        return acc;
+    }
+
+    /*
+     * FIR, from the 4K - 1 tap interpolator on zero-stuffed input (gain 2):
+     *   y[2m]     = 2 * sum_i taps[i] x[m - i]
+     *   y[2m + 1] = x[m - K + 1]                (the centre tap)
+     */
+    static void upFIR(const Design& d, StageState& st, const Batch* in, int n, Batch* out) noexcept
+    {
+        const int size = 2 * d.halfTaps;
+        const Batch two(SampleType(2));
+
+        for (int m = 0; m < n; ++m)
+        {
+            st.upPosition = (st.upPosition == 0 ? size : st.upPosition) - 1;
+            const Batch* window = st.upHistory.data() + st.upPosition;
+            st.upHistory[static_cast<size_t>(st.upPosition)] = st.upHistory[static_cast<size_t>(st.upPosition + size)] = in[m];
+
+            out[2 * m] = two * foldedDot(d, window);
+            out[2 * m + 1] = window[d.halfTaps - 1];
+        }
+    }
+
+    /*
+     * FIR decimator, split into the even-indexed inputs (odd taps) and the
+     * odd-indexed ones (centre tap):
+     *   y[m] = sum_i taps[i] x[2(m - i)] + x[2(m - K) + 1] / 2
+     */
+    static void downFIR(const Design& d, StageState& st, const Batch* in, int n, Batch* out) noexcept
+    {
+        const int size = 2 * d.halfTaps;
+        const int centreSize = d.halfTaps + 1;
+        const Batch half(SampleType(0.5));
+
+        for (int m = 0; m < n; ++m)
+        {
+            st.downPosition = (st.downPosition == 0 ? size : st.downPosition) - 1;
+            const Batch* window = st.downHistory.data() + st.downPosition;
+            st.downHistory[static_cast<size_t>(st.downPosition)] = st.downHistory[static_cast<size_t>(st.downPosition + size)] = in[2 * m];
+
+            // The slot after the one written holds the sample from K steps ago.
+            st.centreDelay[static_cast<size_t>(st.centrePosition)] = in[2 * m + 1];
+            st.centrePosition = st.centrePosition + 1 == centreSize ? 0 : st.centrePosition + 1;
+
+            out[m] = xsimd::fma(half, st.centreDelay[static_cast<size_t>(st.centrePosition)], foldedDot(d, window));
+        }
+    }
+
+    static inline Batch allpass(const Batch& x, SampleType a, Batch& x1, Batch& y1) noexcept
+    {
+        const Batch y = xsimd::fma(Batch(a), x - y1, x1);
+        x1 = x;
+        y1 = y;
+        return y;
+    }
+
+    // IIR: A0 gives the even outputs, A1 the odd ones, both at the input rate.
+    static void upIIR(const Design& d, StageState& st, const Batch* in, int n, Batch* out) noexcept
+    {
+        for (int m = 0; m < n; ++m)
+        {
+            Batch a = in[m], b = in[m];
+            for (int j = 0; j < d.numCoeffs; ++j)
+            {
+                if (j % 2 == 0)
+                    a = allpass(a, d.coeffs[static_cast<size_t>(j)], st.upX[static_cast<size_t>(j)], st.upY[static_cast<size_t>(j)]);
+                else
+                    b = allpass(b, d.coeffs[static_cast<size_t>(j)], st.upX[static_cast<size_t>(j)], st.upY[static_cast<size_t>(j)]);
+            }
+
+            out[2 * m] = a;
+            out[2 * m + 1] = b;
+        }
+    }
+
+    // IIR decimator: A0 on the odd inputs, A1 on the even ones, averaged.
+    static void downIIR(const Design& d, StageState& st, const Batch* in, int n, Batch* out) noexcept
+    {
+        const Batch half(SampleType(0.5));
+
+        for (int m = 0; m < n; ++m)
+        {
+            Batch a = in[2 * m + 1], b = in[2 * m];
+            for (int j = 0; j < d.numCoeffs; ++j)
+            {
+                if (j % 2 == 0)
+                    a = allpass(a, d.coeffs[static_cast<size_t>(j)], st.downX[static_cast<size_t>(j)], st.downY[static_cast<size_t>(j)]);
+                else
+                    b = allpass(b, d.coeffs[static_cast<size_t>(j)], st.downX[static_cast<size_t>(j)], st.downY[static_cast<size_t>(j)]);
+            }
+
+            out[m] = half * (a + b);
+        }
+    }
+
+    std::array<Design, maxStages> designs;
+
+    // Batch frames of every group at each rate, 0 = base ... maxStages = top.
+    std::array<std::vector<Batch>, maxStages + 1> frames;
+    std::vector<StageState> states;
+    std::vector<Pad> pads;
+    juce::AudioBuffer<SampleType> topRate;
+
+    int numPreparedChannels = 0;
+    int numGroups = 0;
+    int numStages = 0;
+    OversamplingPhase phase = OversamplingPhase::Linear;
+    int latency = 0;
+    int padLength = 0;
+};
+
+#endif
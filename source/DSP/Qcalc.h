@@ -6,10 +6,25 @@
 #include <cmath>
 #include <algorithm>
 #include <numbers>
+#include <span>
+#include "FastMath.h"
+#include "xsimd/include/xsimd/xsimd.hpp"
 
 struct BiquadCoeffs { double b0, b1, b2, a1, a2; };
 
+/**
+ * Structure-of-arrays output of Qcalc::calculateBatch: set i is
+ * { b0[i], b1[i], b2[i], a1[i], a2[i] }.
+ */
+template <typename SampleType>
+struct BiquadCoeffSpans { std::span<SampleType> b0, b1, b2, a1, a2; };
+
 enum class QMode { Constant_Q, Proportional_Q };
+
+// Qcalc::calculate (libm) or Qcalc::calculateFast (FastMath.h polynomials).
+enum class DesignMath { Exact, Fast };
+// RBJ's bilinear transforms or Qcalc::calculateMatched.
+enum class DesignMethod { Bilinear, Matched };
 enum class FilterType { Peaking, LowShelf, HighShelf };
 
 class Qcalc {
@@ -39,42 +54,14 @@ public:
         const double cosW0 = std::cos(w0);
         const double sinW0 = std::sin(w0);
 
-        double finalQ = qControl;
-    
-        // Opt 2: Branchless logic for Proportional Q
-        if (type == FilterType::Peaking && mode == QMode::Proportional_Q) {
-            const double minQ = 0.5;
-            const double maxQ = 3.0;
-            // 1.0 / 12.0 = 0.08333...
-            double gainFactor = std::min(std::abs(gainDB) * 0.0833333333333333, 1.0);
-            finalQ = minQ + (gainFactor * (maxQ - minQ));
-            finalQ *= qControl;
-        }
-
-        // Clamp to avoid division by zero / invalid sqrt when parameters are abused.
-        finalQ = std::max(finalQ, 1.0e-9);
+        const double finalQ = peakingQ(gainDB, qControl, mode, type);
 
         double b0, b1, b2, a0, a1, a2;
         
         switch (type) {
             case FilterType::LowShelf: {
                 // (low shelf). For shelves, `qControl` is treated as shelf slope S.
-                const double minS = 1.0e-9;
-                double S = std::max(qControl, minS);
-
-                // Shelf alpha domain constraint (RBJ):
-                // radicand = (A + 1/A) * (1/S - 1) + 2 must be >= 0.
-                // For gain != 0, this implies an upper bound on S:
-                // S <= (A + 1/A) / ((A + 1/A) - 2).
-                const double k = A + (1.0 / A);
-                const double denom = k - 2.0;
-                if (denom > 0.0) {
-                    const double sMax = k / denom;
-                    S = std::min(S, sMax);
-                }
-
-                const double radicand = (k * ((1.0 / S) - 1.0)) + 2.0;
-                const double alpha = (sinW0 / 2.0) * std::sqrt(std::max(radicand, 0.0));
+                const double alpha = (sinW0 / 2.0) * shelfInverseQ(A, qControl);
 
                 const double Ap1 = A + 1.0;
                 const double Am1 = A - 1.0;
@@ -91,22 +78,7 @@ public:
         
             case FilterType::HighShelf: {
                 // (high shelf). For shelves, `qControl` is treated as shelf slope S.
-                const double minS = 1.0e-9;
-                double S = std::max(qControl, minS);
-
-                // Shelf alpha domain constraint (RBJ):
-                // radicand = (A + 1/A) * (1/S - 1) + 2  must be >= 0.
-                // For gain != 0, this implies an upper bound on S:
-                // S <= (A + 1/A) / ((A + 1/A) - 2).
-                const double k = A + (1.0 / A);
-                const double denom = k - 2.0;
-                if (denom > 0.0) {
-                    const double sMax = k / denom;
-                    S = std::min(S, sMax);
-                }
-
-                const double radicand = (k * ((1.0 / S) - 1.0)) + 2.0;
-                const double alpha = (sinW0 / 2.0) * std::sqrt(std::max(radicand, 0.0));
+                const double alpha = (sinW0 / 2.0) * shelfInverseQ(A, qControl);
 
                 const double Ap1 = A + 1.0;
                 const double Am1 = A - 1.0;
@@ -143,6 +115,448 @@ public:
         double invA0 = 1.0 / a0;
         return { b0 * invA0, b1 * invA0, b2 * invA0, a1 * invA0, a2 * invA0 };
     }
+
+    /**
+     * The same bands matched to their analog prototypes instead of bilinear
+     * transformed (Vicanek, "Matched Second Order Digital Filters", 2016).
+     * The bilinear transform squeezes all of the analog response into
+     * [0, Nyquist], so a high shelf or peak close to Nyquist comes out
+     * narrower than drawn and its top is cut off; this design keeps the
+     * analog shape up to Nyquist at the base rate.
+     *
+     * The poles are the analog ones mapped by z = e^(sT) (impulse
+     * invariance). The zeros are then solved for so that |H| equals the
+     * analog magnitude (analogMagnitudeSquared()) at DC, at Nyquist and at
+     * the band's frequency. In between it's within a fraction of a dB of the
+     * analog curve (scripts/MatchedDesignCheck.cpp compares both designs).
+     */
+    static BiquadCoeffs calculateMatched(double sampleRate,
+                                         double frequency,
+                                         double gainDB,
+                                         double qControl,
+                                         QMode mode,
+                                         FilterType type)
+    {
+        if (sampleRate <= 0.0 || frequency <= 0.0) {
+            return { 1.0, 0.0, 0.0, 0.0, 0.0 };
+        }
+
+        frequency = std::clamp(frequency, 1.0e-9, 0.5 * sampleRate - 1.0e-9);
+
+        // A cut is the exact inverse of the boost by as much (in the prototypes
+        // too), so only the side whose poles map well is designed: the boost
+        // for peaks (better damped) and low shelves, the cut for high shelves
+        // (their boost's poles are at sqrt(A) w0, often past Nyquist).
+        if (type == FilterType::HighShelf ? gainDB > 0.0 : gainDB < 0.0)
+        {
+            const auto boost = calculateMatched(sampleRate, frequency, -gainDB, qControl, mode, type);
+            const double invB0 = 1.0 / boost.b0;
+            return { invB0, boost.a1 * invB0, boost.a2 * invB0, boost.b1 * invB0, boost.b2 * invB0 };
+        }
+
+        const double A = std::exp(gainDB * (std::numbers::ln10_v<double> / 40.0));
+        const double sqrtA = std::sqrt(A);
+        const double w0 = (2.0 * std::numbers::pi_v<double>) * frequency / sampleRate;
+
+        // Pole frequency (radians per sample) and Q of the prototype's denominator.
+        double wp = w0, qp;
+        switch (type) {
+            case FilterType::LowShelf:
+                wp = w0 / sqrtA;
+                qp = 1.0 / shelfInverseQ(A, qControl);
+                break;
+
+            case FilterType::HighShelf:
+                wp = w0 * sqrtA;
+                qp = 1.0 / shelfInverseQ(A, qControl);
+                break;
+
+            case FilterType::Peaking:
+            default:
+                qp = A * peakingQ(gainDB, qControl, mode, type);
+                break;
+        }
+
+        const double zeta = 0.5 / qp;
+        const double decay = std::exp(-zeta * wp);
+        const double a1 = zeta <= 1.0 ? -2.0 * decay * std::cos(wp * std::sqrt(1.0 - zeta * zeta))
+                                      : -2.0 * decay * std::cosh(wp * std::sqrt(zeta * zeta - 1.0));
+        const double a2 = decay * decay;
+
+        // |H(e^jw)|^2 = (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2)
+        // with phi0 = cos^2(w/2), phi1 = sin^2(w/2), phi2 = 4 phi0 phi1.
+        const double A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+        const double A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+        const double A2 = -4.0 * a2;
+
+        const double sinHalf = std::sin(0.5 * w0);
+        const double phi1 = sinHalf * sinHalf;
+        const double phi0 = 1.0 - phi1;
+        const double phi2 = 4.0 * phi0 * phi1;
+
+        const double B0 = analogMagnitudeSquared(0.0, gainDB, qControl, mode, type) * A0;
+        const double B1 = analogMagnitudeSquared(std::numbers::pi_v<double> / w0, gainDB, qControl, mode, type) * A1;
+        const double atCentre = analogMagnitudeSquared(1.0, gainDB, qControl, mode, type) * (A0 * phi0 + A1 * phi1 + A2 * phi2);
+
+        // B0 = (b0 + b1 + b2)^2, B1 = (b0 - b1 + b2)^2, B2 = -4 b0 b2.
+        const double sqrtB0 = std::sqrt(B0);
+        const double sqrtB1 = std::sqrt(B1);
+        const double W = 0.5 * (sqrtB0 + sqrtB1);
+
+        // At Nyquist itself the centre and Nyquist points coincide. Wide bands
+        // close to Nyquist can ask for more at the centre than real zeros give
+        // (B2 < -W^2, whose limit puts the zeros on the unit circle); those
+        // keep the bilinear design.
+        const double B2 = phi2 > 1.0e-12 ? (atCentre - B0 * phi0 - B1 * phi1) / phi2 : 0.0;
+        if (W * W + B2 < 0.0)
+            return calculate(sampleRate, frequency, gainDB, qControl, mode, type);
+
+        const double b0 = 0.5 * (W + std::sqrt(W * W + B2));
+        const double b1 = 0.5 * (sqrtB0 - sqrtB1);
+        const double b2 = b0 > 0.0 ? -B2 / (4.0 * b0) : 0.0;
+
+        return { b0, b1, b2, a1, a2 };
+    }
+
+    /**
+     * |H(j w)|^2 of the analog prototype behind a band (RBJ's s-domain forms),
+     * with w in units of the band's frequency (1 = the band's frequency).
+     * What calculateMatched() matches, and the reference for comparing designs.
+     */
+    static double analogMagnitudeSquared(double ratio,
+                                         double gainDB,
+                                         double qControl,
+                                         QMode mode,
+                                         FilterType type)
+    {
+        const double A = std::exp(gainDB * (std::numbers::ln10_v<double> / 40.0));
+        const double sqrtA = std::sqrt(A);
+
+        // H(s) = (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0)
+        double n2, n1, n0, d2, d1, d0;
+        switch (type) {
+            case FilterType::LowShelf: {
+                const double inverseQ = shelfInverseQ(A, qControl);
+                n2 = A;       n1 = A * sqrtA * inverseQ;  n0 = A * A;
+                d2 = A;       d1 = sqrtA * inverseQ;      d0 = 1.0;
+            }
+            break;
+
+            case FilterType::HighShelf: {
+                const double inverseQ = shelfInverseQ(A, qControl);
+                n2 = A * A;   n1 = A * sqrtA * inverseQ;  n0 = A;
+                d2 = 1.0;     d1 = sqrtA * inverseQ;      d0 = A;
+            }
+            break;
+
+            case FilterType::Peaking:
+            default: {
+                const double q = peakingQ(gainDB, qControl, mode, type);
+                n2 = 1.0;     n1 = A / q;                 n0 = 1.0;
+                d2 = 1.0;     d1 = 1.0 / (A * q);         d0 = 1.0;
+            }
+            break;
+        }
+
+        // s = j w: |n0 - n2 w^2 + j n1 w|^2 over the same for d.
+        const double w2 = ratio * ratio;
+        const double num = (n0 - n2 * w2) * (n0 - n2 * w2) + n1 * n1 * w2;
+        const double den = (d0 - d2 * w2) * (d0 - d2 * w2) + d1 * d1 * w2;
+        return num / den;
+    }
+
+    /**
+     * calculate() with FastMath's polynomials in place of exp/sin/cos, and
+     * the formulas rearranged so that one division is left.
+     *
+     * The half-angle sine and cosine come from one sinCos(pi f / fs) (the
+     * tan(w0/2) of the bilinear transform, as a pair), and cos(w0) is taken
+     * as 1 - 2 sin^2 or 2 cos^2 - 1, whichever doesn't cancel. That keeps
+     * 1 - cos(w0) accurate at low frequencies, where the pole radius depends
+     * on it.
+     *
+     * Peaking: every coefficient is scaled by 2QA, so alpha, alpha * A and
+     * alpha / A need no divisions. Shelves: scaled by sqrt(S), 2 sqrt(A) alpha
+     * becomes sin(w0) sqrt((A^2 + 1) - S (A - 1)^2); the two square roots
+     * are independent and the slope clamp (shelfInverseQ()) is the max(0).
+     * The normalisation by a0 is the remaining division.
+     *
+     * Magnitude responses match calculate() to within ~1e-7 dB over the
+     * plugin's range (scripts/FastMathCheck.cpp checks the whole grid).
+     */
+    static BiquadCoeffs calculateFast(double sampleRate,
+                                      double frequency,
+                                      double gainDB,
+                                      double qControl,
+                                      QMode mode,
+                                      FilterType type)
+    {
+        if (sampleRate <= 0.0 || frequency <= 0.0) {
+            return { 1.0, 0.0, 0.0, 0.0, 0.0 };
+        }
+
+        frequency = std::clamp(frequency, 1.0e-9, 0.5 * sampleRate - 1.0e-9);
+
+        const double A = FastMath::dbToA(gainDB);
+
+        double sinHalf, cosHalf;
+        FastMath::sinCos(std::numbers::pi_v<double> * frequency / sampleRate, sinHalf, cosHalf);
+
+        const double sinW0 = 2.0 * sinHalf * cosHalf;
+        const double cosW0 = sinHalf < cosHalf ? 1.0 - 2.0 * sinHalf * sinHalf
+                                               : 2.0 * cosHalf * cosHalf - 1.0;
+
+        double b0, b1, b2, a0, a1, a2;
+
+        if (type == FilterType::Peaking) {
+            const double scale = 2.0 * peakingQ(gainDB, qControl, mode, type) * A;
+            const double sinA2 = sinW0 * A * A;
+
+            b0 = scale + sinA2;
+            b2 = scale - sinA2;
+            a0 = scale + sinW0;
+            a2 = scale - sinW0;
+            b1 = -2.0 * cosW0 * scale;
+            a1 = b1;
+        }
+        else {
+            const double S = std::max(qControl, 1.0e-9);
+            const double sqrtS = std::sqrt(S);
+            const double Ap1 = A + 1.0;
+            const double Am1 = A - 1.0;
+            const double twoSqrtAAlpha = sinW0 * std::sqrt(std::max((A * A + 1.0) - S * Am1 * Am1, 0.0));
+
+            // A high shelf is a low shelf with cos(w0), b1 and a1 negated.
+            const double sign = type == FilterType::LowShelf ? 1.0 : -1.0;
+            const double c = sign * cosW0;
+
+            b0 = A * (sqrtS * (Ap1 - (Am1 * c)) + twoSqrtAAlpha);
+            b1 = sign * 2.0 * A * sqrtS * (Am1 - (Ap1 * c));
+            b2 = A * (sqrtS * (Ap1 - (Am1 * c)) - twoSqrtAAlpha);
+            a0 = sqrtS * (Ap1 + (Am1 * c)) + twoSqrtAAlpha;
+            a1 = sign * -2.0 * sqrtS * (Am1 + (Ap1 * c));
+            a2 = sqrtS * (Ap1 + (Am1 * c)) - twoSqrtAAlpha;
+        }
+
+        const double invA0 = 1.0 / a0;
+        return { b0 * invA0, b1 * invA0, b2 * invA0, a1 * invA0, a2 * invA0 };
+    }
+
+    /**
+     * Design frequency.size() filters at once, one per SIMD lane, with xsimd's
+     * vectorised exp/sin/cos/sqrt. Same formulas as calculate(); every input
+     * span has one entry per filter, and `out` needs room for as many.
+     *
+     * The types can be mixed within a batch: the shelf and peaking forms are
+     * only evaluated for batches that contain them, then blended per lane.
+     * Low and high shelves share one form (a high shelf is a low shelf with
+     * cos(w0) and b1/a1 negated).
+     *
+     * Float carries float rounding through the trig and square roots, so it
+     * matches calculate() only as closely as float allows, least so for
+     * shelves close to their maximum slope, where the design is
+     * ill-conditioned. Double matches to rounding, except at the slope clamp
+     * itself, where calculate() takes the square root of a rounding residue.
+     * QcalcBench.cpp prints both differences.
+     * Templated on the xsimd arch, like the kernels in BiquadKernels.h.
+     */
+    template <typename SampleType, class Arch = xsimd::default_arch>
+    static void calculateBatch(double sampleRate,
+                               std::span<const SampleType> frequency,
+                               std::span<const SampleType> gainDB,
+                               std::span<const SampleType> qControl,
+                               std::span<const FilterType> types,
+                               QMode mode,
+                               BiquadCoeffSpans<SampleType> out)
+    {
+        using B = xsimd::batch<SampleType, Arch>;
+        constexpr auto lanes = B::size;
+        const auto count = frequency.size();
+
+        if (sampleRate <= 0.0)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out.b0[i] = SampleType(1);
+                out.b1[i] = out.b2[i] = out.a1[i] = out.a2[i] = SampleType(0);
+            }
+            return;
+        }
+
+        const SampleType nyquist = static_cast<SampleType>(0.5 * sampleRate - 1.0e-9);
+        const SampleType omegaScale = static_cast<SampleType>(2.0 * std::numbers::pi_v<double> / sampleRate);
+        const SampleType gainScale = static_cast<SampleType>(std::numbers::ln10_v<double> / 40.0);
+        const bool proportional = (mode == QMode::Proportional_Q);
+
+        for (std::size_t first = 0; first < count; first += lanes)
+        {
+            // Unused tail lanes get frequency 0, i.e. the identity filter.
+            alignas(Arch::alignment()) SampleType f[lanes] {}, g[lanes] {}, q[lanes] {}, shelfSign[lanes] {};
+            bool anyPeaking = false, anyShelf = false;
+
+            const auto n = std::min(lanes, count - first);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                f[i] = frequency[first + i];
+                g[i] = gainDB[first + i];
+                q[i] = qControl[first + i];
+
+                // 0 = peaking, +1 = low shelf, -1 = high shelf
+                const FilterType type = types[first + i];
+                shelfSign[i] = type == FilterType::LowShelf ? SampleType(1) : type == FilterType::HighShelf ? SampleType(-1) : SampleType(0);
+                anyPeaking = anyPeaking || shelfSign[i] == SampleType(0);
+                anyShelf = anyShelf || shelfSign[i] != SampleType(0);
+            }
+
+            const B freq = B::load_aligned(f);
+            const B gain = B::load_aligned(g);
+            const B qc = B::load_aligned(q);
+            const B sign = B::load_aligned(shelfSign);
+            const auto valid = freq > B(0);
+
+            const B A = xsimd::exp(gain * B(gainScale));
+            const B w0 = xsimd::min(xsimd::max(freq, B(SampleType(1.0e-9))), B(nyquist)) * B(omegaScale);
+            const B sinW0 = xsimd::sin(w0);
+            const B cosW0 = xsimd::cos(w0);
+
+            B b0(1), b1(0), b2(0), a0(1), a1(0), a2(0);
+
+            if (anyShelf)
+            {
+                // shelfInverseQ(): clamp S so the radicand stays >= 0. At the
+                // clamp the radicand is exactly 0; computing it would leave a
+                // rounding residue that sqrt() magnifies, so it's set directly.
+                const B k = A + B(1) / A;
+                const B denom = k - B(2);
+                const B S = xsimd::max(qc, B(SampleType(1.0e-9)));
+                const auto clamped = (denom > B(0)) && (S * denom >= k);
+                const B radicand = xsimd::select(clamped, B(0), (k * ((B(1) / S) - B(1))) + B(2));
+                const B alpha = (sinW0 / B(2)) * xsimd::sqrt(xsimd::max(radicand, B(0)));
+
+                const B c = cosW0 * sign;
+                const B Ap1 = A + B(1);
+                const B Am1 = A - B(1);
+                const B twoSqrtAAlpha = B(2) * xsimd::sqrt(A) * alpha;
+
+                b0 = A * (Ap1 - (Am1 * c) + twoSqrtAAlpha);
+                b1 = B(2) * A * (Am1 - (Ap1 * c)) * sign;
+                b2 = A * (Ap1 - (Am1 * c) - twoSqrtAAlpha);
+                a0 = Ap1 + (Am1 * c) + twoSqrtAAlpha;
+                a1 = B(-2) * (Am1 + (Ap1 * c)) * sign;
+                a2 = Ap1 + (Am1 * c) - twoSqrtAAlpha;
+            }
+
+            if (anyPeaking)
+            {
+                // peakingQ(): gain-scaled Q in Proportional_Q mode.
+                B finalQ = qc;
+                if (proportional)
+                {
+                    const B gainFactor = xsimd::min(xsimd::abs(gain) * B(SampleType(0.0833333333333333)), B(1));
+                    finalQ = (B(SampleType(0.5)) + (gainFactor * B(SampleType(2.5)))) * qc;
+                }
+                finalQ = xsimd::max(finalQ, B(SampleType(1.0e-9)));
+
+                const B alpha = sinW0 / (B(2) * finalQ);
+                const B pb0 = B(1) + alpha * A;
+                const B pa0 = B(1) + alpha / A;
+                const B pb1 = B(-2) * cosW0;
+
+                const auto isPeaking = sign == B(0);
+                b0 = xsimd::select(isPeaking, pb0, b0);
+                b1 = xsimd::select(isPeaking, pb1, b1);
+                b2 = xsimd::select(isPeaking, B(2) - pb0, b2);
+                a0 = xsimd::select(isPeaking, pa0, a0);
+                a1 = xsimd::select(isPeaking, pb1, a1);
+                a2 = xsimd::select(isPeaking, B(2) - pa0, a2);
+            }
+
+            const B invA0 = B(1) / a0;
+            alignas(Arch::alignment()) SampleType result[5][lanes];
+            xsimd::select(valid, b0 * invA0, B(1)).store_aligned(result[0]);
+            xsimd::select(valid, b1 * invA0, B(0)).store_aligned(result[1]);
+            xsimd::select(valid, b2 * invA0, B(0)).store_aligned(result[2]);
+            xsimd::select(valid, a1 * invA0, B(0)).store_aligned(result[3]);
+            xsimd::select(valid, a2 * invA0, B(0)).store_aligned(result[4]);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out.b0[first + i] = result[0][i];
+                out.b1[first + i] = result[1][i];
+                out.b2[first + i] = result[2][i];
+                out.a1[first + i] = result[3][i];
+                out.a2[first + i] = result[4][i];
+            }
+        }
+    }
+
+    /**
+     * |H(e^jw)|^2 of a normalised biquad at w = 2 pi f / sampleRate. Shared by
+     * the response curve and the linear-phase design (LinearPhase.h).
+     */
+    static double magnitudeSquared(const BiquadCoeffs& c, double omega)
+    {
+        // H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+        // at z = e^(jw): z^-1 = e^(-jw), z^-2 = e^(-2jw)
+        const double cosw = std::cos(omega);
+        const double cos2w = std::cos(2.0 * omega);
+
+        const double numSq = c.b0*c.b0 + c.b1*c.b1 + c.b2*c.b2
+                           + 2.0*(c.b0*c.b1 + c.b1*c.b2)*cosw
+                           + 2.0*c.b0*c.b2*cos2w;
+
+        const double denSq = 1.0 + c.a1*c.a1 + c.a2*c.a2
+                           + 2.0*(c.a1 + c.a1*c.a2)*cosw
+                           + 2.0*c.a2*cos2w;
+
+        return numSq / std::max(denSq, 1.0e-20);
+    }
+
+    /**
+     * The Q a peaking band actually uses: qControl, scaled with gain in
+     * Proportional_Q mode, clamped away from zero. Shelves ignore it.
+     * Shared with the analog-prototype SVF design in Topology.h.
+     */
+    static double peakingQ(double gainDB, double qControl, QMode mode, FilterType type)
+    {
+        double finalQ = qControl;
+    
+        // Opt 2: Branchless logic for Proportional Q
+        if (type == FilterType::Peaking && mode == QMode::Proportional_Q) {
+            const double minQ = 0.5;
+            const double maxQ = 3.0;
+            // 1.0 / 12.0 = 0.08333...
+            double gainFactor = std::min(std::abs(gainDB) * 0.0833333333333333, 1.0);
+            finalQ = minQ + (gainFactor * (maxQ - minQ));
+            finalQ *= qControl;
+        }
+
+        // Clamp to avoid division by zero / invalid sqrt when parameters are abused.
+        return std::max(finalQ, 1.0e-9);
+    }
+
+    /**
+     * 1/Q of an RBJ shelf with amplitude A = 10^(dBgain/40) and slope S = qControl.
+     */
+    static double shelfInverseQ(double A, double qControl)
+    {
+        const double minS = 1.0e-9;
+        double S = std::max(qControl, minS);
+
+        // Shelf alpha domain constraint (RBJ):
+        // radicand = (A + 1/A) * (1/S - 1) + 2 must be >= 0.
+        // For gain != 0, this implies an upper bound on S:
+        // S <= (A + 1/A) / ((A + 1/A) - 2).
+        const double k = A + (1.0 / A);
+        const double denom = k - 2.0;
+        if (denom > 0.0) {
+            const double sMax = k / denom;
+            S = std::min(S, sMax);
+        }
+
+        const double radicand = (k * ((1.0 / S) - 1.0)) + 2.0;
+        return std::sqrt(std::max(radicand, 0.0));
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#ifndef BIQUAD3_REALFFT_H
+#define BIQUAD3_REALFFT_H
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include <vector>
+#include "xsimd/include/xsimd/xsimd.hpp"
+
+/**
+ * Power-of-two FFT of a real signal, in either precision (juce::dsp::FFT
+ * only does float, and the double chain shouldn't round through it).
+ *
+ * The N real samples are packed as N / 2 complex ones, transformed with an
+ * iterative radix-2 FFT and split back into the N / 2 + 1 bins of the real
+ * spectrum. Spectra are kept as separate real and imaginary arrays, which is
+ * what the multiply-adds of a convolution want to stream through; the
+ * butterflies of every stage at least as wide as a SIMD vector run on those
+ * arrays directly, with each stage's twiddles stored contiguously.
+ *
+ * After prepare() nothing allocates and nothing is written but the arrays
+ * passed in, so one instance can serve several threads.
+ */
+template <typename SampleType>
+class RealFFT {
+public:
+    using Batch = xsimd::batch<SampleType>;
+
+    RealFFT() {}
+
+    /**
+     * Build the tables for a size of 2^order (order 2 or more). Allocates.
+     */
+    void prepare(int order)
+    {
+        size = 1 << std::max(order, 2);
+        half = size / 2;
+
+        // Bit reversal of the half-size complex FFT, as the swaps it takes.
+        swaps.clear();
+        for (int i = 0, j = 0; i < half; ++i)
+        {
+            if (i < j)
+                swaps.emplace_back(i, j);
+
+            int bit = half >> 1;
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+            j |= bit;
+        }
+
+        // Stage twiddles: the stage with butterflies h apart uses
+        // e^(-i pi j / h) for j < h, stored at [h, 2h).
+        stageCos.assign(static_cast<size_t>(half), SampleType(0));
+        stageSin.assign(static_cast<size_t>(half), SampleType(0));
+        for (int h = 1; h < half; h *= 2)
+            for (int j = 0; j < h; ++j)
+            {
+                const double angle = -std::numbers::pi * j / h;
+                stageCos[static_cast<size_t>(h + j)] = static_cast<SampleType>(std::cos(angle));
+                stageSin[static_cast<size_t>(h + j)] = static_cast<SampleType>(std::sin(angle));
+            }
+
+        // e^(-2 pi i k / N) for splitting the packed transform, k <= N / 4.
+        splitCos.assign(static_cast<size_t>(half / 2 + 1), SampleType(0));
+        splitSin.assign(static_cast<size_t>(half / 2 + 1), SampleType(0));
+        for (int k = 0; k <= half / 2; ++k)
+        {
+            const double angle = -2.0 * std::numbers::pi * k / size;
+            splitCos[static_cast<size_t>(k)] = static_cast<SampleType>(std::cos(angle));
+            splitSin[static_cast<size_t>(k)] = static_cast<SampleType>(std::sin(angle));
+        }
+    }
+
+    int getSize() const { return size; }
+
+    /** Bins in a spectrum: N / 2 + 1, DC to Nyquist. */
+    int getNumBins() const { return half + 1; }
+
+    /**
+     * Spectrum of `input` (N samples) into re / im (N / 2 + 1 each).
+     */
+    void forward(const SampleType* input, SampleType* re, SampleType* im) const noexcept
+    {
+        for (int n = 0; n < half; ++n)
+        {
+            re[n] = input[2 * n];
+            im[n] = input[2 * n + 1];
+        }
+
+        transform(re, im);
+
+        // X[k] = E[k] + W^k O[k], where E and O (the spectra of the even and
+        // odd samples) come from Z[k] and conj(Z[N/2 - k]); k and N/2 - k are
+        // done together so it can run in place.
+        const SampleType dcRe = re[0], dcIm = im[0];
+        re[0] = dcRe + dcIm;
+        im[0] = SampleType(0);
+        re[half] = dcRe - dcIm;
+        im[half] = SampleType(0);
+
+        for (int k = 1; k <= half / 2; ++k)
+        {
+            const int m = half - k;
+            const SampleType aRe = re[k], aIm = im[k], bRe = re[m], bIm = -im[m];
+            const SampleType eRe = SampleType(0.5) * (aRe + bRe), eIm = SampleType(0.5) * (aIm + bIm);
+            const SampleType oRe = SampleType(0.5) * (aIm - bIm), oIm = SampleType(0.5) * (bRe - aRe);
+            const SampleType wRe = splitCos[static_cast<size_t>(k)], wIm = splitSin[static_cast<size_t>(k)];
+            const SampleType tRe = wRe * oRe - wIm * oIm, tIm = wRe * oIm + wIm * oRe;
+
+            // W^(N/2 - k) O[N/2 - k] = conj(W^k O[k]) negated, E[N/2 - k] = conj(E[k]).
+            re[k] = eRe + tRe;
+            im[k] = eIm + tIm;
+            re[m] = eRe - tRe;
+            im[m] = tIm - eIm;
+        }
+    }
+
+    /**
+     * Signal (N samples) of the spectrum in re / im, so that
+     * inverse(forward(x)) == x. The spectrum is used as scratch space.
+     */
+    void inverse(SampleType* re, SampleType* im, SampleType* output) const noexcept
+    {
+        // Undo the split: Z[k] = E[k] + i O[k] with E[k] = (X[k] + conj(X[N/2 - k])) / 2
+        // and O[k] = (X[k] - conj(X[N/2 - k])) / 2 W^-k.
+        const SampleType dc = re[0], nyquist = re[half];
+        re[0] = SampleType(0.5) * (dc + nyquist);
+        im[0] = SampleType(0.5) * (dc - nyquist);
+
+        for (int k = 1; k <= half / 2; ++k)
+        {
+            const int m = half - k;
+            const SampleType aRe = re[k], aIm = im[k], bRe = re[m], bIm = -im[m];
+            const SampleType eRe = SampleType(0.5) * (aRe + bRe), eIm = SampleType(0.5) * (aIm + bIm);
+            const SampleType dRe = SampleType(0.5) * (aRe - bRe), dIm = SampleType(0.5) * (aIm - bIm);
+            const SampleType wRe = splitCos[static_cast<size_t>(k)], wIm = -splitSin[static_cast<size_t>(k)];
+            const SampleType oRe = wRe * dRe - wIm * dIm, oIm = wRe * dIm + wIm * dRe;
+
+            // The same for N/2 - k: E conjugated, O conjugated and negated.
+            re[k] = eRe - oIm;
+            im[k] = eIm + oRe;
+            re[m] = eRe + oIm;
+            im[m] = oRe - eIm;
+        }
+
+        // Inverse by conjugation: conj(FFT(conj(Z))) / (N / 2).
+        for (int n = 0; n < half; ++n)
+            im[n] = -im[n];
+
+        transform(re, im);
+
+        const SampleType scale = SampleType(1) / static_cast<SampleType>(half);
+        for (int n = 0; n < half; ++n)
+        {
+            output[2 * n] = re[n] * scale;
+            output[2 * n + 1] = -im[n] * scale;
+        }
+    }
+
+private:
+    // In-place forward FFT of the N / 2 complex values in re / im.
+    void transform(SampleType* re, SampleType* im) const noexcept
+    {
+        for (const auto& [i, j] : swaps)
+        {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+
+        constexpr int lanes = static_cast<int>(Batch::size);
+
+        for (int h = 1; h < half; h *= 2)
+        {
+            const SampleType* wRe = stageCos.data() + h;
+            const SampleType* wIm = stageSin.data() + h;
+
+            for (int start = 0; start < half; start += 2 * h)
+            {
+                SampleType* aRe = re + start;
+                SampleType* aIm = im + start;
+                SampleType* bRe = aRe + h;
+                SampleType* bIm = aIm + h;
+
+                int j = 0;
+                if (h >= lanes)
+                {
+                    for (; j < h; j += lanes)
+                    {
+                        const Batch cRe = Batch::load_unaligned(wRe + j), cIm = Batch::load_unaligned(wIm + j);
+                        const Batch xRe = Batch::load_unaligned(bRe + j), xIm = Batch::load_unaligned(bIm + j);
+                        const Batch tRe = xsimd::fms(cRe, xRe, cIm * xIm);
+                        const Batch tIm = xsimd::fma(cRe, xIm, cIm * xRe);
+                        const Batch uRe = Batch::load_unaligned(aRe + j), uIm = Batch::load_unaligned(aIm + j);
+
+                        (uRe + tRe).store_unaligned(aRe + j);
+                        (uIm + tIm).store_unaligned(aIm + j);
+                        (uRe - tRe).store_unaligned(bRe + j);
+                        (uIm - tIm).store_unaligned(bIm + j);
+                    }
+                }
+
+                for (; j < h; ++j)
+                {
+                    const SampleType tRe = wRe[j] * bRe[j] - wIm[j] * bIm[j];
+                    const SampleType tIm = wRe[j] * bIm[j] + wIm[j] * bRe[j];
+                    bRe[j] = aRe[j] - tRe;
+                    bIm[j] = aIm[j] - tIm;
+                    aRe[j] += tRe;
+                    aIm[j] += tIm;
+                }
+            }
+        }
+    }
+
+    int size = 0;
+    int half = 0;
+
+    std::vector<std::pair<int, int>> swaps;
+    std::vector<SampleType> stageCos, stageSin;
+    std::vector<SampleType> splitCos, splitSin;
+};
+
+#endif
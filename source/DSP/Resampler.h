@@ -4,16 +4,216 @@
 #define BIQUAD3_RESAMPLER_H
 
 #include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "xsimd/include/xsimd/xsimd.hpp"
+#include "BiquadKernels.h"
 #include "Interpolator.h"
 
+/**
+ * Streaming sample-rate converter for any ratio, with the interpolation
+ * picked at compile time from Interpolator.h, e.g.
+ * Resampler<Interpolators::WindowedSinc<float>>.
+ *
+ * The read position advances by inputRate / outputRate per output sample,
+ * kept as a whole index plus an exact fraction (both rates reduced by their
+ * gcd when they're whole numbers), so it never drifts however long it runs.
+ *
+ * Channels are packed into SIMD lanes as in BiquadSIMD: the input history is
+ * stored as frames of one vector per group of channels, and each output is
+ * the weighted sum of numTaps frames, so the multiply-adds run over channels
+ * while the weights are computed once for all of them (the sinc's blend of
+ * table rows runs over taps).
+ *
+ * Each process() call takes any number of input samples up to the prepared
+ * maximum and returns how many output samples it wrote; that count varies
+ * by one from call to call with non-integer ratios. Running a processor at a
+ * fixed internal rate takes one converter each way and a FIFO on the way
+ * back to absorb that; offline conversion just feeds the file through.
+ * Nothing allocates after prepare().
+ *
+ * Output sample j is the input at time j * inputRate / outputRate exactly;
+ * it can only be computed once numTaps / 2 further input samples have
+ * arrived, which is the latency getLatencySamples() reports.
+ */
 template <typename InterpolationType>
 class Resampler {
 public:
+    using SampleType = typename InterpolationType::SampleType;
+    using Batch = xsimd::batch<SampleType>;
+    using Kernels = BiquadKernels<xsimd::default_arch>;
+
+    static constexpr int numTaps = InterpolationType::numTaps;
+    static constexpr int lanes = static_cast<int>(Batch::size);
+    static constexpr int maxChannels = maxKernelChannels;
+
     Resampler() {}
 
+    /**
+     * Set the rates, build the interpolator and allocate the history.
+     *
+     * @param inputRate Sample rate of the input in Hz
+     * @param outputRate Sample rate of the output in Hz
+     * @param numChannels Channel count (1 to maxChannels)
+     * @param maxInputSamples Largest number of input samples per process() call
+     */
+    void prepare(double inputRate, double outputRate, int numChannels, int maxInputSamples)
+    {
+        setRatio(inputRate, outputRate);
+        interpolator.prepare(outputRate / inputRate);
+
+        numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+        capacity = numTaps + std::max(maxInputSamples, 1);
+        history.assign(static_cast<size_t>(((numPreparedChannels + lanes - 1) / lanes) * capacity), Batch(SampleType(0)));
+
+        reset();
+    }
+
+    /**
+     * Clear the history and restart the read position at the next input sample.
+     */
+    void reset()
+    {
+        std::fill(history.begin(), history.end(), Batch(SampleType(0)));
+
+        // Zeros before the first sample, so output 0 lands on input 0.
+        available = numTaps / 2 - 1;
+        index = 0;
+        fraction = 0;
+    }
+
+    /**
+     * Input samples an output waits for: it's computed when the input
+     * numTaps / 2 samples past its position arrives.
+     */
+    int getLatencySamples() const { return numTaps / 2; }
+
+    /**
+     * The most output samples process() can write for numInputSamples of input.
+     */
+    int getMaxOutputSamples(int numInputSamples) const
+    {
+        return static_cast<int>((static_cast<std::int64_t>(numInputSamples + numTaps) * denominator) / numerator) + 1;
+    }
+
+    /**
+     * Convert a block. Output must have room for getMaxOutputSamples(numInputSamples).
+     *
+     * @param input Channel pointers of the input
+     * @param numChannels Channels in both input and output
+     * @param numInputSamples Samples per input channel (up to the prepared maximum)
+     * @param output Channel pointers of the output
+     * @param maxOutputSamples Room per output channel
+     * @return The number of output samples written
+     */
+    int process(const SampleType* const* input, int numChannels, int numInputSamples,
+                SampleType* const* output, int maxOutputSamples) noexcept
+    {
+        numChannels = std::min(numChannels, numPreparedChannels);
+        numInputSamples = std::clamp(numInputSamples, 0, capacity - available);
+
+        for (int first = 0, g = 0; first < numChannels; first += lanes, ++g)
+        {
+            Batch* frames = groupHistory(g) + available;
+            const int count = std::min(lanes, numChannels - first);
+            for (int i = 0; i < numInputSamples; ++i)
+                frames[i] = Kernels::gather(input + first, count, i);
+        }
+        available += numInputSamples;
+
+        alignas(64) std::array<SampleType, numTaps> w;
+        const SampleType scale = SampleType(1) / static_cast<SampleType>(denominator);
+
+        int produced = 0;
+        for (; index + numTaps <= available && produced < maxOutputSamples; ++produced)
+        {
+            interpolator.weights(static_cast<SampleType>(fraction) * scale, w.data());
+
+            for (int first = 0, g = 0; first < numChannels; first += lanes, ++g)
+            {
+                const Batch* frames = groupHistory(g) + index;
+
+                Batch acc(SampleType(0));
+                for (int k = 0; k < numTaps; ++k)
+                    acc = xsimd::fma(Batch(w[static_cast<size_t>(k)]), frames[k], acc);
+
+                Kernels::scatter(acc, output + first, std::min(lanes, numChannels - first), produced);
+            }
+
+            index += stepWhole;
+            fraction += stepFraction;
+            if (fraction >= denominator)
+            {
+                fraction -= denominator;
+                ++index;
+            }
+        }
+
+        // Keep what the next outputs still need; when downsampling the position
+        // may already be past everything that arrived.
+        const int keep = std::max(available - index, 0);
+        for (int first = 0, g = 0; first < numChannels; first += lanes, ++g)
+        {
+            Batch* frames = groupHistory(g);
+            std::copy(frames + (available - keep), frames + available, frames);
+        }
+
+        index -= available - keep;
+        available = keep;
+
+        return produced;
+    }
+
 private:
-    std::vector<float> buffer;
-    int writeIdx = 0;
+    // inputRate / outputRate = numerator / denominator, exactly if both are whole.
+    void setRatio(double inputRate, double outputRate)
+    {
+        constexpr double maxRate = 1 << 30;
+        const bool whole = inputRate == std::floor(inputRate) && outputRate == std::floor(outputRate)
+                        && inputRate <= maxRate && outputRate <= maxRate;
+
+        if (whole)
+        {
+            const auto in = static_cast<std::int64_t>(inputRate), out = static_cast<std::int64_t>(outputRate);
+            const auto divisor = std::gcd(in, out);
+            numerator = in / divisor;
+            denominator = out / divisor;
+        }
+        else
+        {
+            denominator = std::int64_t(1) << 24;
+            numerator = std::llround(inputRate / outputRate * static_cast<double>(denominator));
+        }
+
+        stepWhole = static_cast<int>(numerator / denominator);
+        stepFraction = numerator % denominator;
+    }
+
+    Batch* groupHistory(int group) noexcept
+    {
+        return history.data() + group * capacity;
+    }
+
+    InterpolationType interpolator;
+
+    // Input frames of every group, capacity each; [0, available) are live and
+    // the next output reads [index, index + numTaps).
+    std::vector<Batch> history;
+    int capacity = 0;
+    int available = 0;
+    int index = 0;
+
+    // Read position past `index`, in 1 / denominator steps
+    std::int64_t fraction = 0;
+    std::int64_t numerator = 1, denominator = 1;
+    int stepWhole = 1;
+    std::int64_t stepFraction = 0;
+
+    int numPreparedChannels = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
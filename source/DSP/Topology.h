@@ -0,0 +1,340 @@
+#pragma once
+
+#ifndef BIQUAD3_TOPOLOGY_H
+#define BIQUAD3_TOPOLOGY_H
+
+#include <array>
+#include <cmath>
+#include <numbers>
+#include "Qcalc.h"
+
+/*
+ * Filter structures for the biquad kernels.
+ *
+ * Every structure realises the same second-order transfer function, but they
+ * differ in how they behave when the coefficients move every sample and in how
+ * rounding noise builds up at low frequencies:
+ *
+ *     DF2T     2 states, 5 coefficients. Cheapest; the default everywhere.
+ *     DF1      4 states. Its states are past inputs/outputs, so a coefficient
+ *              jump can't leave the internal state inconsistent with the
+ *              signal. That makes it robust under fast modulation.
+ *     TPTSVF   Zavalishin/Simper zero-delay-feedback state-variable filter.
+ *              Its states are physical integrator outputs, so it stays well
+ *              behaved under audio-rate modulation and has low noise at low
+ *              frequencies. It can be designed straight from the analog
+ *              prototype with a single tan() (fromPrototype), skipping RBJ.
+ *     Lattice  Gray-Markel normalised lattice-ladder. Every section is a
+ *              rotation, so internal signals stay bounded and the coefficients
+ *              quantise gracefully.
+ *
+ * A policy is a set of static members:
+ *
+ *     id, name, numCoeffs, numStates
+ *     Params                  the coefficients in double
+ *     fromBiquad(BiquadCoeffs) -> Params
+ *     tick<T>(x, c, s)        one step; c and s point at numCoeffs / numStates values
+ *     isStable(Params)        whether the coefficients give a stable filter
+ *     convexStability         true if every point on a straight line between two
+ *                             stable coefficient sets is stable too, so a linear
+ *                             coefficient ramp only needs its ends checked
+ *     directForm              true if Params is { b0, b1, b2, a1, a2 }
+ *     zeroStateAtUnity        true if, with b == a (a unity band), the state stops
+ *                             depending on the input and decays to zero, so a
+ *                             unity band whose state has decayed can be skipped
+ *                             and later resumed from a zero state without a click
+ *
+ * tick() only uses +, - and *, so the same code runs on floats, doubles and any
+ * xsimd batch. It's what the dispatched kernels (BiquadKernels.h) and the
+ * per-sample paths (BiquadSIMD) inline. Policies with
+ * `prototypeDesign = true` also have fromPrototype(), which Engine uses
+ * instead of going through Qcalc.
+ */
+
+inline constexpr int numTopologies = 4;
+inline constexpr int maxTopologyCoeffs = 8;
+inline constexpr int maxTopologyStates = 4;
+
+/**
+ * Direct Form II Transposed.
+ * c = { b0, b1, b2, a1, a2 }, s = { z1, z2 }
+ */
+struct DF2T
+{
+    static constexpr int id = 0;
+    static constexpr const char* name = "DF2T";
+    static constexpr int numCoeffs = 5;
+    static constexpr int numStates = 2;
+    static constexpr bool prototypeDesign = false;
+    static constexpr bool convexStability = true;
+    static constexpr bool directForm = true;
+    // With b == a, s0' = s1 - s0 a1 and s1' = -s0 a2: the input drops out.
+    static constexpr bool zeroStateAtUnity = true;
+
+    using Params = std::array<double, numCoeffs>;
+
+    static Params fromBiquad(const BiquadCoeffs& c) noexcept { return { c.b0, c.b1, c.b2, c.a1, c.a2 }; }
+
+    // Inside the stability triangle |a2| < 1, |a1| < 1 + a2.
+    static bool isStable(const Params& p) noexcept { return std::abs(p[4]) < 1.0 && std::abs(p[3]) < 1.0 + p[4]; }
+
+    template <typename T>
+    static inline T tick(const T& x, const T* c, T* s) noexcept
+    {
+        const T y = x * c[0] + s[0];
+        s[0] = (x * c[1] + s[1]) - (y * c[3]);
+        s[1] = (x * c[2]) - (y * c[4]);
+        return y;
+    }
+};
+
+/**
+ * Direct Form I.
+ * c = { b0, b1, b2, a1, a2 }, s = { x[n-1], x[n-2], y[n-1], y[n-2] }
+ */
+struct DF1
+{
+    static constexpr int id = 1;
+    static constexpr const char* name = "DF1";
+    static constexpr int numCoeffs = 5;
+    static constexpr int numStates = 4;
+    static constexpr bool prototypeDesign = false;
+    static constexpr bool convexStability = true;
+    static constexpr bool directForm = true;
+    static constexpr bool zeroStateAtUnity = false;
+
+    using Params = std::array<double, numCoeffs>;
+
+    static Params fromBiquad(const BiquadCoeffs& c) noexcept { return { c.b0, c.b1, c.b2, c.a1, c.a2 }; }
+
+    // Inside the stability triangle |a2| < 1, |a1| < 1 + a2.
+    static bool isStable(const Params& p) noexcept { return std::abs(p[4]) < 1.0 && std::abs(p[3]) < 1.0 + p[4]; }
+
+    template <typename T>
+    static inline T tick(const T& x, const T* c, T* s) noexcept
+    {
+        const T y = (x * c[0] + s[0] * c[1] + s[1] * c[2]) - (s[2] * c[3] + s[3] * c[4]);
+        s[1] = s[0];
+        s[0] = x;
+        s[3] = s[2];
+        s[2] = y;
+        return y;
+    }
+};
+
+/**
+ * Trapezoidal (TPT) state-variable filter, in Simper's form.
+ * c = { a1, a2, a3, m0, m1, m2 }, s = { ic1eq, ic2eq }
+ *
+ * With g = tan(pi f / fs) and damping k = 1/Q:
+ *     a1 = 1 / (1 + g (g + k)),  a2 = g a1,  a3 = g a2
+ * and the output mixes input, band-pass and low-pass: y = m0 x + m1 v1 + m2 v2.
+ */
+struct TPTSVF
+{
+    static constexpr int id = 2;
+    static constexpr const char* name = "TPT SVF";
+    static constexpr int numCoeffs = 6;
+    static constexpr int numStates = 2;
+    static constexpr bool prototypeDesign = true;
+    static constexpr bool convexStability = false;
+    static constexpr bool directForm = false;
+    static constexpr bool zeroStateAtUnity = false;
+
+    using Params = std::array<double, numCoeffs>;
+
+    static Params fromGainAndMix(double g, double k, double m0, double m1, double m2) noexcept
+    {
+        const double a1 = 1.0 / (1.0 + g * (g + k));
+        const double a2 = g * a1;
+        const double a3 = g * a2;
+        return { a1, a2, a3, m0, m1, m2 };
+    }
+
+    /**
+     * Analog-prototype design: the same responses as Qcalc (RBJ peaking and
+     * shelves are the bilinear transforms of these prototypes), for one tan().
+     */
+    static Params fromPrototype(double sampleRate, double frequency, double gainDB, double qControl,
+                                QMode mode, FilterType type) noexcept
+    {
+        if (sampleRate <= 0.0 || frequency <= 0.0)
+            return fromGainAndMix(1.0, 2.0, 1.0, 0.0, 0.0);
+
+        frequency = std::clamp(frequency, 1.0e-9, 0.5 * sampleRate - 1.0e-9);
+
+        const double A = std::exp(gainDB * (std::numbers::ln10_v<double> / 40.0));
+        const double g = std::tan(std::numbers::pi_v<double> * frequency / sampleRate);
+
+        switch (type)
+        {
+            case FilterType::LowShelf:
+            {
+                const double k = Qcalc::shelfInverseQ(A, qControl);
+                return fromGainAndMix(g / std::sqrt(A), k, 1.0, k * (A - 1.0), A * A - 1.0);
+            }
+
+            case FilterType::HighShelf:
+            {
+                const double k = Qcalc::shelfInverseQ(A, qControl);
+                return fromGainAndMix(g * std::sqrt(A), k, A * A, k * (1.0 - A) * A, 1.0 - A * A);
+            }
+
+            case FilterType::Peaking:
+            default:
+            {
+                const double k = 1.0 / (Qcalc::peakingQ(gainDB, qControl, mode, type) * A);
+                return fromGainAndMix(g, k, 1.0, k * (A * A - 1.0), 0.0);
+            }
+        }
+    }
+
+    /**
+     * Exact re-parametrisation of a digital biquad. Needs the poles away from
+     * z = +/-1, which holds for every stable Qcalc design.
+     *
+     * The SVF denominator normalised to a0 = 1 gives
+     *     g^2 = (1 + a1 + a2) / (1 - a1 + a2),  g k = 2 (1 - a2) / (1 - a1 + a2)
+     * and matching b against m0 (1 + a1 z^-1 + a2 z^-2) + m1 BP(z) + m2 LP(z),
+     * with BP = g/D (1 - z^-2) and LP = g^2/D (1 + z^-1)^2, D = 1 + g k + g^2,
+     * gives the mix.
+     */
+    static Params fromBiquad(const BiquadCoeffs& c) noexcept
+    {
+        const double den = 1.0 - c.a1 + c.a2;
+        const double g = std::sqrt(std::max((1.0 + c.a1 + c.a2) / den, 1.0e-30));
+        const double k = 2.0 * (1.0 - c.a2) / (den * g);
+        const double D = 1.0 + g * k + g * g;
+
+        const double m0 = (c.b0 - c.b1 + c.b2) / den;
+        const double lowPass = 0.5 * (c.b1 - m0 * c.a1);
+        const double bandPass = 0.5 * (c.b0 - c.b2 - m0 * (1.0 - c.a2));
+
+        return fromGainAndMix(g, k, m0, bandPass * D / g, lowPass * D / (g * g));
+    }
+
+    /**
+     * Stable iff g > 0 and k > 0. With g = a3 / a2 and k = (1/a1 - 1) / g - g
+     * that's a2, a3 > 0, 0 < a1 < 1 and (1 - a1) a2^2 > a1 a3^2, which isn't a
+     * convex set: a straight ramp between two stable designs can pass through
+     * k <= 0, so ramps are checked point by point.
+     */
+    static bool isStable(const Params& p) noexcept
+    {
+        return p[0] > 0.0 && p[0] < 1.0 && p[1] > 0.0 && p[2] > 0.0
+            && (1.0 - p[0]) * p[1] * p[1] > p[0] * p[2] * p[2];
+    }
+
+    template <typename T>
+    static inline T tick(const T& x, const T* c, T* s) noexcept
+    {
+        const T v3 = x - s[1];
+        const T v1 = c[0] * s[0] + c[1] * v3;
+        const T v2 = s[1] + c[1] * s[0] + c[2] * v3;
+        s[0] = (v1 + v1) - s[0];
+        s[1] = (v2 + v2) - s[1];
+        return c[3] * x + c[4] * v1 + c[5] * v2;
+    }
+};
+
+/**
+ * Normalised (Gray-Markel) lattice with a ladder output.
+ * c = { k1, c1, k2, c2, v0, v1, v2 }, s = { g0[n-1], g1[n-1] }, c_m = sqrt(1 - k_m^2)
+ */
+struct Lattice
+{
+    static constexpr int id = 3;
+    static constexpr const char* name = "Lattice";
+    static constexpr int numCoeffs = 7;
+    static constexpr int numStates = 2;
+    static constexpr bool prototypeDesign = false;
+    static constexpr bool convexStability = true;
+    static constexpr bool directForm = false;
+    static constexpr bool zeroStateAtUnity = false;
+
+    using Params = std::array<double, numCoeffs>;
+
+    /**
+     * Reflection coefficients from the denominator (step-down recursion), then the
+     * ladder taps: each tap's response times A(z) is a polynomial of degree <= 2,
+     * so matching the numerator is a 3x3 linear solve.
+     */
+    static Params fromBiquad(const BiquadCoeffs& c) noexcept
+    {
+        const double k2 = c.a2;
+        const double k1 = c.a1 / (1.0 + c.a2);
+
+        Params p { k1, std::sqrt(std::max(1.0 - k1 * k1, 0.0)),
+                   k2, std::sqrt(std::max(1.0 - k2 * k2, 0.0)),
+                   0.0, 0.0, 0.0 };
+
+        // Impulse response of each tap for three samples.
+        double h[3][3] {};
+        double s[2] {};
+        for (int n = 0; n < 3; ++n)
+        {
+            const double x = (n == 0) ? 1.0 : 0.0;
+            const double f1 = p[3] * x - p[2] * s[1];
+            const double g2 = p[2] * x + p[3] * s[1];
+            const double f0 = p[1] * f1 - p[0] * s[0];
+            const double g1 = p[0] * f1 + p[1] * s[0];
+            h[0][n] = f0;
+            h[1][n] = g1;
+            h[2][n] = g2;
+            s[0] = f0;
+            s[1] = g1;
+        }
+
+        // M[n][m] = (A * h_m)[n]
+        const double a[3] { 1.0, c.a1, c.a2 };
+        double M[3][3] {};
+        for (int n = 0; n < 3; ++n)
+            for (int m = 0; m < 3; ++m)
+                for (int j = 0; j <= n; ++j)
+                    M[n][m] += a[j] * h[m][n - j];
+
+        const double b[3] { c.b0, c.b1, c.b2 };
+        const double det = M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+                         - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+                         + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+
+        if (std::abs(det) < 1.0e-300)
+            return p;
+
+        for (int m = 0; m < 3; ++m)
+        {
+            double Mm[3][3];
+            for (int n = 0; n < 3; ++n)
+                for (int j = 0; j < 3; ++j)
+                    Mm[n][j] = (j == m) ? b[n] : M[n][j];
+
+            const double detM = Mm[0][0] * (Mm[1][1] * Mm[2][2] - Mm[1][2] * Mm[2][1])
+                              - Mm[0][1] * (Mm[1][0] * Mm[2][2] - Mm[1][2] * Mm[2][0])
+                              + Mm[0][2] * (Mm[1][0] * Mm[2][1] - Mm[1][1] * Mm[2][0]);
+
+            p[static_cast<size_t>(4 + m)] = detM / det;
+        }
+
+        return p;
+    }
+
+    /**
+     * |k1|, |k2| < 1. Between two valid designs the interpolated (k, c) pairs
+     * stay inside the unit disc, so each section is still a contraction.
+     */
+    static bool isStable(const Params& p) noexcept { return std::abs(p[0]) < 1.0 && std::abs(p[2]) < 1.0; }
+
+    template <typename T>
+    static inline T tick(const T& x, const T* c, T* s) noexcept
+    {
+        const T f1 = c[3] * x - c[2] * s[1];
+        const T g2 = c[2] * x + c[3] * s[1];
+        const T f0 = c[1] * f1 - c[0] * s[0];
+        const T g1 = c[0] * f1 + c[1] * s[0];
+        s[0] = f0;
+        s[1] = g1;
+        return c[4] * f0 + c[5] * g1 + c[6] * g2;
+    }
+};
+
+#endif
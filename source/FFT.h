@@ -5,6 +5,10 @@
 
 #include <JuceHeader.h>
 #include "SPSC.h"
+#include "AnalyzerService.h"
+#include "Utils/TripleBuffer.h"
+#include "Utils/Parameters.h"
+#include <array>
 #include <atomic>
 
 // Forward declaration
@@ -17,42 +21,54 @@ enum FFTOrder
     order8192 = 13
 };
 
+// The analyzer's stages run one after another on the analyzer worker, so
+// they hand their results on by swapping preallocated buffers rather than
+// queueing copies: once the sizes settle nothing is allocated per frame.
+
 template<typename BlockType>
 struct FFTDataGenerator
 {
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
+    /**
+     * Both channels of `audioData` in one complex FFT, left as
+     * the real part and right as the imaginary part, windowed in the same
+     * pass. With Z the transform of l + i r, conjugate symmetry gives
+     * L[k] = (Z[k] + conj(Z[N - k])) / 2 and R[k] = (Z[k] - conj(Z[N - k])) / 2i,
+     * so one complex FFT does the work of two real ones. Take the frames
+     * with getStereoFFTData().
+     */
+    void produceStereoFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
     {
         const auto fftSize = getFFTSize();
+        auto* left = audioData.getReadPointer(0);
+        auto* right = audioData.getReadPointer(juce::jmin(1, audioData.getNumChannels() - 1));
 
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
-
-        window->multiplyWithWindowingTable (fftData.data(), fftSize);
-        forwardFFT->performFrequencyOnlyForwardTransform (fftData.data());
+        for( int n = 0; n < fftSize; ++n )
+        {
+            const auto w = windowTable[(size_t)n];
+            stereoInput[(size_t)n] = { left[n] * w, right[n] * w };
+        }
 
-        int numBins = (int)fftSize / 2;
+        forwardFFT->perform (stereoInput.data(), stereoOutput.data(), false);
 
-        for( int i = 0; i < numBins; ++i )
+        // Magnitudes only: |Z[k] + conj(Z[N - k])| / 2 and |Z[k] - conj(Z[N - k])| / 2.
+        auto& leftData = fftData[0];
+        auto& rightData = fftData[1];
+        const int numBins = fftSize / 2;
+        for( int k = 0; k < numBins; ++k )
         {
-            auto v = fftData[i];
-            if( !std::isinf(v) && !std::isnan(v) )
-            {
-                v /= float(numBins);
-            }
-            else
-            {
-                v = 0.f;
-            }
-            fftData[i] = v;
+            const auto z = stereoOutput[(size_t)k];
+            const auto mirror = stereoOutput[(size_t)((fftSize - k) & (fftSize - 1))];
+            leftData[(size_t)k] = 0.5f * std::hypot(z.real() + mirror.real(), z.imag() - mirror.imag());
+            rightData[(size_t)k] = 0.5f * std::hypot(z.real() - mirror.real(), z.imag() + mirror.imag());
         }
 
-        for( int i = 0; i < numBins; ++i )
+        for( int channel = 0; channel < 2; ++channel )
         {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+            toDecibels(fftData[(size_t)channel], negativeInfinity);
+            std::swap(fftData[(size_t)channel], latestData[(size_t)channel]);
         }
 
-        fftDataFifo.push(fftData);
+        hasNewData = true;
     }
 
     void changeOrder(FFTOrder newOrder)
@@ -61,24 +77,69 @@ struct FFTDataGenerator
         auto fftSize = getFFTSize();
 
         forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
 
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
+        // The window itself, for the stereo pass to apply to both channels at once.
+        windowTable.assign((size_t)fftSize, 1.0f);
+        juce::dsp::WindowingFunction<float>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris)
+            .multiplyWithWindowingTable (windowTable.data(), fftSize);
+        stereoInput.assign((size_t)fftSize, {});
+        stereoOutput.assign((size_t)fftSize, {});
 
-        fftDataFifo.prepare(fftData.size());
+        for( int channel = 0; channel < 2; ++channel )
+        {
+            fftData[(size_t)channel].assign(getDataSize(), 0.0f);
+            latestData[(size_t)channel].assign(getDataSize(), 0.0f);
+        }
+        hasNewData = false;
     }
 
     int getFFTSize() const { return 1 << order; }
-    int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+
+    // Size of the blocks getStereoFFTData() swaps in; the caller's must match.
+    size_t getDataSize() const { return static_cast<size_t>(getFFTSize()) * 2; }
+
+    // Swaps both channels of the newest frame into `left` and `right`, which
+    // must be getDataSize() long; the generator keeps the old ones to write
+    // the next frame into.
+    bool getStereoFFTData(BlockType& left, BlockType& right)
+    {
+        if( ! hasNewData )
+            return false;
+
+        jassert(left.size() == latestData[0].size() && right.size() == latestData[1].size());
+        std::swap(left, latestData[0]);
+        std::swap(right, latestData[1]);
+        hasNewData = false;
+        return true;
+    }
 private:
+    // Scale the magnitudes in the first half of `data` to the bin count and convert to dB.
+    static void toDecibels(BlockType& data, const float negativeInfinity)
+    {
+        const int numBins = (int)data.size() / 4;
+
+        for( int i = 0; i < numBins; ++i )
+        {
+            auto v = data[(size_t)i];
+            if( !std::isinf(v) && !std::isnan(v) )
+            {
+                v /= float(numBins);
+            }
+            else
+            {
+                v = 0.f;
+            }
+            data[(size_t)i] = juce::Decibels::gainToDecibels(v, negativeInfinity);
+        }
+    }
+
     FFTOrder order;
-    BlockType fftData;
+    std::array<BlockType, 2> fftData, latestData;
+    bool hasNewData = false;
     std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
 
-    Fifo<BlockType> fftDataFifo;
+    std::vector<float> windowTable;
+    std::vector<juce::dsp::Complex<float>> stereoInput, stereoOutput;
 };
 
 template<typename PathType>
@@ -96,8 +157,11 @@ struct AnalyzerPathGenerator
 
         int numBins = (int)fftSize / 2;
 
-        PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+        // Room for every point (three floats each); cleared paths keep their
+        // storage, so each path object only allocates the first time.
+        PathType& p = workingPath;
+        p.clear();
+        p.preallocateSpace(3 * (numBins / 2 + 2));
 
         auto map = [bottom, top, negativeInfinity](float v)
         {
@@ -128,89 +192,197 @@ struct AnalyzerPathGenerator
             }
         }
 
-        pathFifo.push(p);
-    }
-
-    int getNumPathsAvailable() const
-    {
-        return pathFifo.getNumAvailableForReading();
+        hasNewPath = true;
     }
 
+    // Swaps the newest path into `path`; the old one is reused for the next.
     bool getPath(PathType& path)
     {
-        return pathFifo.pull(path);
+        if( ! hasNewPath )
+            return false;
+
+        path.swapWithPath(workingPath);
+        hasNewPath = false;
+        return true;
     }
 private:
-    Fifo<PathType> pathFifo;
+    PathType workingPath;
+    bool hasNewPath = false;
 };
 
-struct PathProducer
+// Both analyzer channels: rendered together on the AnalyzerService worker
+// with one stereo FFT per frame, and handed to the editor as a pair of paths
+// through a triple buffer.
+//
+// The FFT runs on the newest window once at least a hop's worth of new
+// samples has come in, and at most once per frame: whatever arrived in
+// between only slides the window along, since the display would never show
+// those frames. Analyzer work follows the frame rate and hop, not the host's
+// block size.
+struct PathProducer : AnalyzerService::Client
 {
-    PathProducer(SingleChannelSampleFifo<juce::AudioBuffer<float>>& scsf) :
-    channelFifo(&scsf)
+    using ChannelFifo = SingleChannelSampleFifo<juce::AudioBuffer<float>>;
+
+    static constexpr double defaultOverlap = 0.5;
+
+    PathProducer(ChannelFifo& left, ChannelFifo& right) :
+    channelFifos { &left, &right }
     {
         fftDataGenerator.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, fftDataGenerator.getFFTSize());
+        stereoBuffer.setSize(2, fftDataGenerator.getFFTSize());
+        for( size_t channel = 0; channel < 2; ++channel )
+        {
+            incomingBuffers[channel].setSize(1, juce::jmax(channelFifos[channel]->getSize(), 1));
+            renderData[channel].assign(fftDataGenerator.getDataSize(), 0.0f);
+        }
+
+        // Start from now, not from whatever the taps kept while no editor was open.
+        syncTaps();
     }
 
-    void process(juce::Rectangle<float> fftBounds, double sampleRate)
+    // Message thread: where to draw and the rate to label bins with, for the next frames.
+    void setView(juce::Rectangle<float> fftBounds, double sampleRate)
     {
-        juce::AudioBuffer<float> tempIncomingBuffer;
-        while( channelFifo->getNumCompleteBuffersAvailable() > 0 )
+        boundsX.store(fftBounds.getX());
+        boundsY.store(fftBounds.getY());
+        boundsWidth.store(fftBounds.getWidth());
+        boundsHeight.store(fftBounds.getHeight());
+        viewSampleRate.store(sampleRate);
+    }
+
+    // Any thread: how much consecutive FFT windows overlap (0 to 0.95), so
+    // the hop is (1 - overlap) of the FFT size. The taps deliver fixed-size
+    // chunks, so in effect the hop rounds up to a whole number of them.
+    void setOverlap(double newOverlap) { overlap.store(juce::jlimit(0.0, 0.95, newOverlap)); }
+    double getOverlap() const { return overlap.load(); }
+
+    // Worker thread.
+    // Once every buffer in rotation has been filled this doesn't allocate;
+    // scripts/AnalyzerAllocationCheck.cpp checks that with a malloc hook.
+    void produceFrame() override
+    {
+        const juce::Rectangle<float> fftBounds(boundsX.load(), boundsY.load(), boundsWidth.load(), boundsHeight.load());
+        if( process(fftBounds, viewSampleRate.load()) )
         {
-            if( channelFifo->getAudioBuffer(tempIncomingBuffer) )
+            // The finished paths go out; the ones swapped back are reused.
+            auto& out = paths.getWriteBuffer();
+            for( size_t channel = 0; channel < 2; ++channel )
+                out[channel].swapWithPath(channelFFTPaths[channel]);
+            paths.publish();
+        }
+    }
+
+    // Message thread: take the newest finished paths, if there are some. @return true if getPath() changed
+    bool fetchPaths() { return paths.pull(); }
+
+    // Message thread: a channel's path (0 = left, 1 = right) taken by the last fetchPaths().
+    const juce::Path& getPath(int channel) const { return paths.read()[(size_t)channel]; }
+
+private:
+    int getHopSize() const
+    {
+        const auto fftSize = fftDataGenerator.getFFTSize();
+        return juce::jmax(1, (int)std::lround(fftSize * (1.0 - overlap.load())));
+    }
+
+    // @return true if new paths were made
+    bool process(juce::Rectangle<float> fftBounds, double sampleRate)
+    {
+        // Both taps get the same blocks, so they're read in step: a block
+        // from each or from neither. Everything that's come in slides through
+        // the window; only the newest window is analysed.
+        while( channelFifos[0]->getNumCompleteBuffersAvailable() > 0 &&
+               channelFifos[1]->getNumCompleteBuffersAvailable() > 0 )
+        {
+            // Only fails if the taps' block size changed in between (the
+            // host re-preparing); start again in step rather than drift.
+            const bool gotLeft = channelFifos[0]->getAudioBuffer(incomingBuffers[0]);
+            const bool gotRight = channelFifos[1]->getAudioBuffer(incomingBuffers[1]);
+            if( ! gotLeft || ! gotRight )
+            {
+                syncTaps();
+                break;
+            }
+
+            for( size_t channel = 0; channel < 2; ++channel )
             {
-                auto size = tempIncomingBuffer.getNumSamples();
+                const auto& incoming = incomingBuffers[channel];
+                const int ch = (int)channel;
+                auto size = incoming.getNumSamples();
 
-                juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
-                                                  monoBuffer.getReadPointer(0, size),
-                                                  monoBuffer.getNumSamples() - size);
+                juce::FloatVectorOperations::copy(stereoBuffer.getWritePointer(ch, 0),
+                                                  stereoBuffer.getReadPointer(ch, size),
+                                                  stereoBuffer.getNumSamples() - size);
 
-                juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                                                  tempIncomingBuffer.getReadPointer(0, 0),
+                juce::FloatVectorOperations::copy(stereoBuffer.getWritePointer(ch, stereoBuffer.getNumSamples() - size),
+                                                  incoming.getReadPointer(0, 0),
                                                   size);
-
-                fftDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
             }
+
+            samplesSinceFFT += incomingBuffers[0].getNumSamples();
         }
 
+        if( samplesSinceFFT < getHopSize() )
+            return false;
+
+        // The hops skipped since the last frame are gone, not owed.
+        samplesSinceFFT = 0;
+        fftDataGenerator.produceStereoFFTDataForRendering(stereoBuffer, -48.f);
+
         const auto fftSize = fftDataGenerator.getFFTSize();
         const auto binWidth = sampleRate / double(fftSize);
 
-        while( fftDataGenerator.getNumAvailableFFTDataBlocks() > 0 )
-        {
-            std::vector<float> fftData;
-            if( fftDataGenerator.getFFTData(fftData) )
-            {
-                pathGenerator.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
-            }
-        }
+        if( ! fftDataGenerator.getStereoFFTData(renderData[0], renderData[1]) )
+            return false;
 
-        while( pathGenerator.getNumPathsAvailable() > 0 )
+        bool madePaths = false;
+        for( size_t channel = 0; channel < 2; ++channel )
         {
-            pathGenerator.getPath(channelFFTPath);
+            auto& generator = pathGenerators[channel];
+            generator.generatePath(renderData[channel], fftBounds, fftSize, binWidth, -48.f);
+            madePaths = generator.getPath(channelFFTPaths[channel]) || madePaths;
         }
+
+        return madePaths;
     }
 
-    juce::Path getPath() { return channelFFTPath; }
+    // Skip both taps to the newer of their positions that both have
+    // reached. The audio thread may be between the two taps' updates, so
+    // that's the one that's behind.
+    void syncTaps()
+    {
+        const auto leftPosition = channelFifos[0]->getWritePosition();
+        const auto rightPosition = channelFifos[1]->getWritePosition();
+        const auto position = static_cast<std::int32_t>(rightPosition - leftPosition) < 0 ? rightPosition : leftPosition;
+        channelFifos[0]->discardUntil(position);
+        channelFifos[1]->discardUntil(position);
+    }
 
-private:
-    SingleChannelSampleFifo<juce::AudioBuffer<float>>* channelFifo;
+    std::array<ChannelFifo*, 2> channelFifos;
 
-    juce::AudioBuffer<float> monoBuffer;
+    juce::AudioBuffer<float> stereoBuffer;
+    std::array<juce::AudioBuffer<float>, 2> incomingBuffers;
+    std::array<std::vector<float>, 2> renderData;
 
     FFTDataGenerator<std::vector<float>> fftDataGenerator;
 
-    AnalyzerPathGenerator<juce::Path> pathGenerator;
+    std::array<AnalyzerPathGenerator<juce::Path>, 2> pathGenerators;
+
+    std::array<juce::Path, 2> channelFFTPaths;
+    int samplesSinceFFT = 0;
+
+    std::atomic<double> overlap { defaultOverlap };
+
+    TripleBuffer<std::array<juce::Path, 2>> paths;
 
-    juce::Path channelFFTPath;
+    std::atomic<float> boundsX { 0.0f }, boundsY { 0.0f }, boundsWidth { 0.0f }, boundsHeight { 0.0f };
+    std::atomic<double> viewSampleRate { 44100.0 };
 };
 
 //==============================================================================
 // FFT Spectrum Component - displays the FFT analysis
 struct FFTSpectrumComponent : juce::Component,
-                             juce::Timer,
-                             juce::AudioProcessorValueTreeState::Listener
+                             juce::Timer
 {
     FFTSpectrumComponent(PluginProcessor& p);
     ~FFTSpectrumComponent() override;
@@ -224,32 +396,33 @@ struct FFTSpectrumComponent : juce::Component,
     void mouseDrag (const juce::MouseEvent& e) override;
     void mouseUp   (const juce::MouseEvent& e) override;
 
-    void parameterChanged (const juce::String& parameterID, float newValue) override;
-
 private:
     PluginProcessor& processorRef;
 
-    PathProducer leftPathProducer, rightPathProducer;
+    PathProducer pathProducer;
+
+    // Renders the producer off the message thread, shared with every other editor.
+    std::shared_ptr<AnalyzerService> analyzer;
+
+
+    // Right-click: how much the analyzer's FFT windows overlap.
+    void showAnalyzerMenu();
 
     void drawBackgroundGrid(juce::Graphics& g);
     void drawTextLabels(juce::Graphics& g);
     void drawResponseCurve(juce::Graphics& g);
 
-    enum class DragHandle
-    {
-        none,
-        lowShelf,
-        midPeak,
-        highShelf
-    };
+    // A handle is the index of the band it drags; one per running band.
+    static constexpr int noHandle = -1;
 
     void drawDragHandles(juce::Graphics& g);
-    juce::Point<float> getHandlePosition(DragHandle h);
-    DragHandle getHandleAtPosition(juce::Point<float> pos);
+    int getNumHandles();
+    juce::Point<float> getHandlePosition(int band);
+    int getHandleAtPosition(juce::Point<float> pos);
 
-    void beginGestureForHandle(DragHandle h);
-    void endGestureForHandle(DragHandle h);
-    void setHandleFromPosition(DragHandle h, juce::Point<float> pos);
+    void beginGestureForHandle(int band);
+    void endGestureForHandle(int band);
+    void setHandleFromPosition(int band, juce::Point<float> pos);
 
     static void setParameterValue(juce::AudioProcessorValueTreeState& apvts,
                                   const juce::String& paramID,
@@ -257,14 +430,12 @@ private:
     static void beginGesture(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID);
     static void endGesture  (juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID);
 
-    DragHandle activeHandle { DragHandle::none };
+    int activeHandle { noHandle };
 
-    std::atomic<float> hsFreqHz { 1000.0f };
-    std::atomic<float> hsGainDb { 0.0f };
-    std::atomic<float> mpFreqHz { 1000.0f };
-    std::atomic<float> mpGainDb { 0.0f };
-    std::atomic<float> lsFreqHz { 1000.0f };
-    std::atomic<float> lsGainDb { 0.0f };
+    // Cached so the handles read the parameters without looking up their IDs.
+    std::array<std::atomic<float>*, maxEqBands> bandFreqParams {};
+    std::array<std::atomic<float>*, maxEqBands> bandGainParams {};
+    std::atomic<float>* numBandsParam { nullptr };
 
     std::atomic<bool> hoverAnyHandle { false };
 
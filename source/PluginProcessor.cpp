@@ -2,6 +2,9 @@
 #include "PluginEditor.h"
 #include "Utils/Parameters.h"
 
+static_assert(maxEqBands <= Cascade<float>::maxBands && maxEqBands <= LinearPhaseDesigner::maxBands,
+              "Every band parameter needs a band in the chains.");
+
 //==============================================================================
 PluginProcessor::PluginProcessor()
     : AudioProcessor(BusesProperties()
@@ -10,37 +13,71 @@ PluginProcessor::PluginProcessor()
       vts(*this, nullptr, "PARAMETERS", createParameterLayout())
 {
     // Get raw parameter pointers for real-time safe access
-    highShelfParam = vts.getRawParameterValue(highShelfID.getParamID());
-    highShelfGainParam = vts.getRawParameterValue(highShelfGainID.getParamID());
-    midPeakParam = vts.getRawParameterValue(midPeakID.getParamID());
-    midPeakGainParam = vts.getRawParameterValue(midPeakGainID.getParamID());
-    lowShelfParam = vts.getRawParameterValue(lowShelfID.getParamID());
-    lowShelfGainParam = vts.getRawParameterValue(lowShelfGainID.getParamID());
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        const auto band = static_cast<size_t>(b);
+        bandFreqParams[band] = vts.getRawParameterValue(bandFreqID(b).getParamID());
+        bandGainParams[band] = vts.getRawParameterValue(bandGainID(b).getParamID());
+        bandTypeParams[band] = vts.getRawParameterValue(bandTypeID(b).getParamID());
+    }
+    numBandsParam = vts.getRawParameterValue(numBandsID.getParamID());
     qModeParam = vts.getRawParameterValue(qModeID.getParamID());
+    designMethodParam = vts.getRawParameterValue(designMethodID.getParamID());
     bypassParam = vts.getRawParameterValue(bypassID.getParamID());
+    osChoiceParam = vts.getRawParameterValue(osChoiceID.getParamID());
+    osPhaseParam = vts.getRawParameterValue(osPhaseID.getParamID());
+    eqModeParam = vts.getRawParameterValue(eqModeID.getParamID());
+
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        snapshotIndices.set(bandFreqID(b).getParamID(), numBandFields * b);
+        snapshotIndices.set(bandGainID(b).getParamID(), numBandFields * b + 1);
+        snapshotIndices.set(bandTypeID(b).getParamID(), numBandFields * b + 2);
+    }
+    snapshotIndices.set(numBandsID.getParamID(), numBandsIndex);
+    snapshotIndices.set(qModeID.getParamID(), qModeIndex);
+    snapshotIndices.set(designMethodID.getParamID(), designMethodIndex);
 
     // Add parameter listeners
-    vts.addParameterListener(highShelfID.getParamID(), this);
-    vts.addParameterListener(highShelfGainID.getParamID(), this);
-    vts.addParameterListener(midPeakID.getParamID(), this);
-    vts.addParameterListener(midPeakGainID.getParamID(), this);
-    vts.addParameterListener(lowShelfID.getParamID(), this);
-    vts.addParameterListener(lowShelfGainID.getParamID(), this);
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        vts.addParameterListener(bandFreqID(b).getParamID(), this);
+        vts.addParameterListener(bandGainID(b).getParamID(), this);
+        vts.addParameterListener(bandTypeID(b).getParamID(), this);
+    }
+    vts.addParameterListener(numBandsID.getParamID(), this);
     vts.addParameterListener(qModeID.getParamID(), this);
+    vts.addParameterListener(designMethodID.getParamID(), this);
     vts.addParameterListener(bypassID.getParamID(), this);
+    vts.addParameterListener(osChoiceID.getParamID(), this);
+    vts.addParameterListener(osPhaseID.getParamID(), this);
+    vts.addParameterListener(eqModeID.getParamID(), this);
+
+    // The first snapshot, taken by prepareToPlay().
+    publishParameters();
+
+    // Probe the CPU for the kernel set here, not on the audio thread's first
+    // block. getActiveKernelName() reports the choice.
+    Dispatch::getKernels();
 }
 
 PluginProcessor::~PluginProcessor()
 {
     // Remove parameter listeners
-    vts.removeParameterListener(highShelfID.getParamID(), this);
-    vts.removeParameterListener(highShelfGainID.getParamID(), this);
-    vts.removeParameterListener(midPeakID.getParamID(), this);
-    vts.removeParameterListener(midPeakGainID.getParamID(), this);
-    vts.removeParameterListener(lowShelfID.getParamID(), this);
-    vts.removeParameterListener(lowShelfGainID.getParamID(), this);
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        vts.removeParameterListener(bandFreqID(b).getParamID(), this);
+        vts.removeParameterListener(bandGainID(b).getParamID(), this);
+        vts.removeParameterListener(bandTypeID(b).getParamID(), this);
+    }
+    vts.removeParameterListener(numBandsID.getParamID(), this);
     vts.removeParameterListener(qModeID.getParamID(), this);
+    vts.removeParameterListener(designMethodID.getParamID(), this);
     vts.removeParameterListener(bypassID.getParamID(), this);
+    vts.removeParameterListener(osChoiceID.getParamID(), this);
+    vts.removeParameterListener(osPhaseID.getParamID(), this);
+    vts.removeParameterListener(eqModeID.getParamID(), this);
+    cancelPendingUpdate();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLayout()
@@ -109,6 +146,78 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0  // default: Constant Q
     ));
 
+    // Filter Design: Bilinear (RBJ) or Matched (analog shape up to Nyquist), default Bilinear
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        designMethodID,
+        designMethodName,
+        designMethodItems,
+        0  // default: Bilinear
+    ));
+
+    // Oversampling: Off, 2x, 4x, 8x, 16x (default Off)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        osChoiceID,
+        osChoiceName,
+        osItems,
+        0  // default: Off
+    ));
+
+    // Oversampling filters: Linear Phase or Minimum Phase (default Linear Phase)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        osPhaseID,
+        osPhaseName,
+        osPhaseItems,
+        0  // default: Linear Phase
+    ));
+
+    // EQ Mode: Minimum Phase (the IIR bands) or Linear Phase (default Minimum Phase)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        eqModeID,
+        eqModeName,
+        eqModeItems,
+        0  // default: Minimum Phase
+    ));
+
+    // Bands: how many of the bands run (1 - 16, default 3)
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        numBandsID,
+        numBandsName,
+        1,
+        maxEqBands,
+        defaultNumBands
+    ));
+
+    // Band types: any FilterType per band (default High Shelf, Peaking, Low Shelf, then Peaking)
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            bandTypeID(b),
+            bandTypeName(b),
+            filterTypeItems,
+            defaultBandType(b)
+        ));
+    }
+
+    // Bands 4 - 16: frequency (20Hz - 20kHz, spread out) and gain (-24dB to +24dB, default 0dB)
+    for (int b = 3; b < maxEqBands; ++b)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            bandFreqID(b),
+            bandFreqName(b),
+            juce::NormalisableRange<float>(20.0f, 20000.0f, 0.1f, 0.3f),
+            defaultBandFrequency(b),
+            juce::AudioParameterFloatAttributes().withLabel("Hz")
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            bandGainID(b),
+            bandGainName(b),
+            juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f, 1.0f),
+            0.0f,
+            juce::AudioParameterFloatAttributes().withLabel("dB")
+        ));
+    }
+
     // Bypass: On/Off (default Off)
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         bypassID,
@@ -123,38 +232,188 @@ void PluginProcessor::parameterChanged(const juce::String& paramID, float newVal
 {
     juce::ignoreUnused(newValue);
     
-    // Update engine parameters when any filter or Q mode parameter changes
-    if (paramID == highShelfID.getParamID() || 
-        paramID == highShelfGainID.getParamID() ||
-        paramID == midPeakID.getParamID() || 
-        paramID == midPeakGainID.getParamID() ||
-        paramID == lowShelfID.getParamID() ||
-        paramID == lowShelfGainID.getParamID() ||
-        paramID == qModeID.getParamID())
+    // Publish a new snapshot when any band, band count, Q mode or design parameter changes
+    if (getSnapshotIndex(paramID) >= 0)
+        publishParameters();
+
+    // Mode changes are prepared on the message thread.
+    else if (paramID == osChoiceID.getParamID() || paramID == osPhaseID.getParamID() || paramID == eqModeID.getParamID())
+        triggerAsyncUpdate();
+}
+
+int PluginProcessor::getSnapshotIndex(const juce::String& paramID) const
+{
+    // Hashing and comparing the ID doesn't allocate.
+    return snapshotIndices.contains(paramID) ? snapshotIndices[paramID] : -1;
+}
+
+// `value` is the plain parameter value; choices are indices into their item
+// lists, which follow the enums.
+void PluginProcessor::setSnapshotField(ParameterSnapshot& snapshot, int index, float value)
+{
+    if (index < numBandsIndex)
+    {
+        auto& band = snapshot.bands[static_cast<size_t>(index / numBandFields)];
+        switch (index % numBandFields)
+        {
+            case 0: band.frequency = value; break;
+            case 1: band.gainDB = value; break;
+            default: band.type = static_cast<FilterType>(juce::roundToInt(value)); break;
+        }
+    }
+    else if (index == numBandsIndex)
+        snapshot.numBands = juce::jlimit(1, maxEqBands, juce::roundToInt(value));
+    else if (index == qModeIndex)
+        snapshot.qMode = value < 0.5f ? QMode::Constant_Q : QMode::Proportional_Q;
+    else if (index == designMethodIndex)
+        snapshot.designMethod = value > 0.5f ? DesignMethod::Matched : DesignMethod::Bilinear;
+}
+
+float PluginProcessor::getSnapshotField(const ParameterSnapshot& snapshot, int index)
+{
+    if (index < numBandsIndex)
     {
-        updateParameters();
+        const auto& band = snapshot.bands[static_cast<size_t>(index / numBandFields)];
+        switch (index % numBandFields)
+        {
+            case 0: return band.frequency;
+            case 1: return band.gainDB;
+            default: return static_cast<float>(band.type);
+        }
     }
+
+    if (index == numBandsIndex)
+        return static_cast<float>(snapshot.numBands);
+    if (index == qModeIndex)
+        return snapshot.qMode == QMode::Constant_Q ? 0.0f : 1.0f;
+
+    return snapshot.designMethod == DesignMethod::Matched ? 1.0f : 0.0f;
 }
 
-void PluginProcessor::updateParameters()
+void PluginProcessor::publishParameters()
 {
-    if (highShelfParam == nullptr || highShelfGainParam == nullptr ||
-        midPeakParam == nullptr || midPeakGainParam == nullptr ||
-        lowShelfParam == nullptr || lowShelfGainParam == nullptr ||
-        qModeParam == nullptr)
+    if (qModeParam == nullptr || numBandsParam == nullptr || designMethodParam == nullptr)
         return;
 
-    // Get current Q mode from parameter (0 = Constant_Q, 1 = Proportional_Q)
-    const QMode currentQMode = (qModeParam->load() < 0.5f) ? QMode::Constant_Q : QMode::Proportional_Q;
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        const auto band = static_cast<size_t>(b);
+        if (bandFreqParams[band] == nullptr || bandGainParams[band] == nullptr || bandTypeParams[band] == nullptr)
+            return;
+    }
 
-    // Engine 0: High Shelf filter
-    engines[0].setParameters(highShelfParam->load(), highShelfGainParam->load(), defaultQ, FilterType::HighShelf, currentQMode);
+    // Hosts may call parameterChanged() from several threads at once. Rather
+    // than wait, a thread that finds another one publishing leaves it a note
+    // to read the parameters again once it's done.
+    publishPending.store(true);
+    while (! publishing.exchange(true, std::memory_order_acquire))
+    {
+        while (publishPending.exchange(false))
+        {
+            auto& snapshot = parameterSnapshots.getWriteBuffer();
+            for (int b = 0; b < maxEqBands; ++b)
+            {
+                const auto band = static_cast<size_t>(b);
+                setSnapshotField(snapshot, numBandFields * b, bandFreqParams[band]->load());
+                setSnapshotField(snapshot, numBandFields * b + 1, bandGainParams[band]->load());
+                setSnapshotField(snapshot, numBandFields * b + 2, bandTypeParams[band]->load());
+            }
+
+            setSnapshotField(snapshot, numBandsIndex, numBandsParam->load());
+            setSnapshotField(snapshot, qModeIndex, qModeParam->load());
+            setSnapshotField(snapshot, designMethodIndex, designMethodParam->load());
+            parameterSnapshots.publish();
+        }
 
-    // Engine 1: Mid-Peak (Peaking) filter
-    engines[1].setParameters(midPeakParam->load(), midPeakGainParam->load(), defaultQ, FilterType::Peaking, currentQMode);
+        publishing.store(false, std::memory_order_release);
 
-    // Engine 2: Low Shelf filter
-    engines[2].setParameters(lowShelfParam->load(), lowShelfGainParam->load(), defaultQ, FilterType::LowShelf, currentQMode);
+        // A note left after the last check but before the release is ours to handle.
+        if (! publishPending.load())
+            break;
+    }
+}
+
+bool PluginProcessor::queueParameterChange(const juce::String& paramID, int sampleOffset, float value)
+{
+    const int index = getSnapshotIndex(paramID);
+    if (index < 0)
+        return false;
+
+    return parameterEvents.push({ nextBlockStart.load() + std::max(sampleOffset, 0), index, value });
+}
+
+void PluginProcessor::applyEvent(const ParameterEvent& event)
+{
+    setSnapshotField(settings, event.parameter, event.value);
+    settingsChanged = true;
+}
+
+void PluginProcessor::updateParameters(bool immediate)
+{
+    // Take the fields a new snapshot changed; the rest keep what the
+    // timestamped events last set them to.
+    if (parameterSnapshots.pull())
+    {
+        const auto& snapshot = parameterSnapshots.read();
+        for (int index = 0; index < numSnapshotFields; ++index)
+        {
+            const float value = getSnapshotField(snapshot, index);
+            if (value != getSnapshotField(lastSnapshot, index))
+                setSnapshotField(settings, index, value);
+        }
+
+        lastSnapshot = snapshot;
+        settingsChanged = true;
+    }
+
+    // Nothing to do unless something changed, or the bands have to be set
+    // outright (after prepare() or coming out of bypass).
+    if (settingsChanged || immediate)
+        applySettings(immediate);
+}
+
+void PluginProcessor::applySettings(bool immediate)
+{
+    settingsChanged = false;
+
+    // A change of design method redesigns now rather than at the next move.
+    const bool redesign = immediate || settings.designMethod != designMethod;
+    designMethod = settings.designMethod;
+
+    auto setBand = [&](auto& band, const BandSettings& bandSettings)
+    {
+        if (redesign)
+            band.setParametersImmediate(bandSettings.frequency, bandSettings.gainDB, defaultQ, bandSettings.type, settings.qMode);
+        else
+            band.setParameters(bandSettings.frequency, bandSettings.gainDB, defaultQ, bandSettings.type, settings.qMode);
+    };
+
+    // Every band gets its settings, running or not, so one that's switched
+    // back on glides from where it was rather than from the defaults. Bands
+    // joining the chain start from silence.
+    auto setBands = [&](auto& chain)
+    {
+        chain.setDesignMethod(settings.designMethod);
+        chain.setNumBands(settings.numBands);
+
+        for (int b = 0; b < maxEqBands; ++b)
+            setBand(chain.getBand(b), settings.bands[static_cast<size_t>(b)]);
+    };
+
+    setBands(modePath.chain());
+    setBands(modePathDouble.chain());
+
+    // The linear-phase designer only takes the settings here; its thread
+    // designs them once for both precisions (and ignores them while the mode
+    // is off). Bands past the count are set flat, which leaves them out of
+    // the design.
+    linearPhaseDesigner.setQMode(settings.qMode);
+    linearPhaseDesigner.setDesignMethod(settings.designMethod);
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        const auto& band = settings.bands[static_cast<size_t>(b)];
+        linearPhaseDesigner.setBand(b, band.frequency, b < settings.numBands ? band.gainDB : 0.0f, defaultQ, band.type);
+    }
 }
 
 //==============================================================================
@@ -192,7 +451,7 @@ bool PluginProcessor::isMidiEffect() const
 
 double PluginProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load();
 }
 
 int PluginProcessor::getNumPrograms()
@@ -224,15 +483,84 @@ void PluginProcessor::changeProgramName(int index, const juce::String &newName)
 
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Prepare all engines with the current sample rate and block size
-    for (auto& engine : engines)
-    {
-        engine.prepare(sampleRate, samplesPerBlock);
-    }
+#if BIQUAD3_COEFF_TABLE
+    // Coefficient designs come from a table shared by every instance and cached
+    // on disk between runs (CoeffTable.h); set it before prepare() designs.
+    coeffTable = CoeffTable::getShared(sampleRate, defaultQ,
+                                       juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                                           .getChildFile(JucePlugin_Manufacturer)
+                                           .getChildFile(JucePlugin_Name));
+    for (auto& chain : modePath.chains)
+        chain.setCoefficientTable(coeffTable);
+    for (auto& chain : modePathDouble.chains)
+        chain.setCoefficientTable(coeffTable);
+#endif
 
-    // Prepare FFT FIFOs
-    leftChannelFifo.prepare(samplesPerBlock);
-    rightChannelFifo.prepare(samplesPerBlock);
+    // Both paths are prepared; the host may switch precision before the next call.
+    // The oversamplers allocate for 16x, and prepareMode() prepares each
+    // chain at the oversampled rate. The linear-phase filters are designed
+    // for the current settings as they're prepared.
+    const juce::ScopedLock lock(modeLock);
+    const int numChannels = getTotalNumOutputChannels();
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+    subBlockChannels.assign(static_cast<size_t>(numChannels), nullptr);
+    subBlockChannelsDouble.assign(static_cast<size_t>(numChannels), nullptr);
+
+    // Event times restart here; anything still queued is applied at the first block.
+    blockStart = 0;
+    nextBlockStart.store(0);
+    for (auto& os : modePath.oversamplers)
+        os.prepare(numChannels);
+    for (auto& os : modePathDouble.oversamplers)
+        os.prepare(numChannels);
+    updateParameters(true);
+    linearPhaseDesigner.prepare(sampleRate);
+    linearPhase.prepare(numChannels);
+    linearPhaseDouble.prepare(numChannels);
+    linearPhaseDesigner.start();
+
+    // After the input stops, the FIR rings for its whole length; the
+    // oversampling filters add their delay on top. Whichever mode runs, this
+    // covers it.
+    tailLengthSeconds.store((linearPhase.getFilterLength() + modePath.oversampler().getMaxLatencySamples()
+                             + modePath.chain().getLatencySamples()) / sampleRate);
+
+    // Start fully on or off, whichever bypass is set to. The dry path is
+    // delayed by the latency of either mode, up to the largest setting.
+    const bool bypassed = bypassParam != nullptr && bypassParam->load() > 0.5f;
+    bypassFade.prepare(sampleRate, samplesPerBlock, numChannels);
+    bypassFadeDouble.prepare(sampleRate, samplesPerBlock, numChannels);
+    bypassFade.prepareLatency(std::max(modePath.oversampler().getMaxLatencySamples() + modePath.chain().getLatencySamples(),
+                                       linearPhase.getLatencySamples()));
+    bypassFadeDouble.prepareLatency(std::max(modePathDouble.oversampler().getMaxLatencySamples()
+                                                 + modePathDouble.chain().getLatencySamples(),
+                                             linearPhaseDouble.getLatencySamples()));
+    bypassFade.setBypassed(bypassed);
+    bypassFadeDouble.setBypassed(bypassed);
+    bypassFade.finishFade();
+    bypassFadeDouble.finishFade();
+    filtersIdle = false;
+    filtersIdleDouble = false;
+
+    // The current mode, swapped in straight away: nothing is running yet. A
+    // standby left from before is dropped; an update still pending finds
+    // nothing to do.
+    currentMode = readMode();
+    linearPhase.setEnabled(false);
+    linearPhaseDouble.setEnabled(false);
+    modePath.standbyState.store(Idle);
+    modePathDouble.standbyState.store(Idle);
+    prepareMode(modePath, linearPhase, currentMode);
+    prepareMode(modePathDouble, linearPhaseDouble, currentMode);
+    updateMode(modePath, linearPhase, bypassFade);
+    updateMode(modePathDouble, linearPhaseDouble, bypassFadeDouble);
+    linearPhaseDesigner.setEnabled(currentMode.linearPhase);
+    setLatencySamples(currentMode.latency);
+
+    // Prepare FFT FIFOs: the analyzer reads them in its own block size, whatever the host sends.
+    leftChannelFifo.prepare(analyzerBlockSize);
+    rightChannelFifo.prepare(analyzerBlockSize);
 
     // Set initial parameters
     updateParameters();
@@ -248,10 +576,10 @@ bool PluginProcessor::isBusesLayoutSupported(const BusesLayout &layouts) const
     juce::ignoreUnused(layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-        layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout from mono up to 64 discrete channels. The engine packs the
+    // channels into SIMD lanes, so the speaker arrangement itself doesn't matter.
+    const int numChannels = layouts.getMainOutputChannelSet().size();
+    if (numChannels < 1 || numChannels > maxKernelChannels)
         return false;
 
         // This checks if the input layout matches the output layout
@@ -268,6 +596,127 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                    juce::MidiBuffer &midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer, modePath, linearPhase, bypassFade, false);
+}
+
+// 64-bit hosts get the double chain directly, with no conversion pass.
+void PluginProcessor::processBlock(juce::AudioBuffer<double> &buffer,
+                                   juce::MidiBuffer &midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, modePathDouble, linearPhaseDouble, bypassFadeDouble, false);
+}
+
+// Hosts that bypass without going through getBypassParameter() call these
+// instead; they take the same crossfade as the parameter.
+void PluginProcessor::processBlockBypassed(juce::AudioBuffer<float> &buffer,
+                                           juce::MidiBuffer &midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, modePath, linearPhase, bypassFade, true);
+}
+
+void PluginProcessor::processBlockBypassed(juce::AudioBuffer<double> &buffer,
+                                           juce::MidiBuffer &midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, modePathDouble, linearPhaseDouble, bypassFadeDouble, true);
+}
+
+juce::AudioProcessorParameter* PluginProcessor::getBypassParameter() const
+{
+    return vts.getParameter(bypassID.getParamID());
+}
+
+PluginProcessor::ProcessingMode PluginProcessor::readMode() const
+{
+    ProcessingMode mode;
+    mode.numStages = osChoiceParam != nullptr ? juce::roundToInt(osChoiceParam->load()) : 0;
+    mode.phase = osPhaseParam != nullptr && osPhaseParam->load() > 0.5f ? OversamplingPhase::Minimum
+                                                                         : OversamplingPhase::Linear;
+    mode.linearPhase = eqModeParam != nullptr && eqModeParam->load() > 0.5f;
+    return mode;
+}
+
+void PluginProcessor::handleAsyncUpdate()
+{
+    const juce::ScopedLock lock(modeLock);
+
+    auto mode = readMode();
+    if (mode.isSameSetting(currentMode))
+        return;
+
+    // A path whose audio thread is taking its standby right now gets it
+    // again on the next message.
+    if (! prepareMode(modePath, linearPhase, mode) || ! prepareMode(modePathDouble, linearPhaseDouble, mode))
+    {
+        triggerAsyncUpdate();
+        return;
+    }
+
+    currentMode = mode;
+    linearPhaseDesigner.setEnabled(mode.linearPhase);
+    setLatencySamples(mode.latency);
+}
+
+template <typename SampleType>
+bool PluginProcessor::prepareMode(ModePath<SampleType> &path, LinearPhaseEQ<SampleType> &linear, ProcessingMode &mode)
+{
+    // A standby that's Ready but not yet taken is prepared again.
+    int state = path.standbyState.load();
+    if ((state != Idle && state != Ready)
+        || ! path.standbyState.compare_exchange_strong(state, Preparing, std::memory_order_acquire))
+        return false;
+
+    // Allocation-free: the oversampler only switches stages, and preparing the
+    // chain just resets its smoothers and state for the new rate. It starts
+    // from silence, so a switch while playing isn't seamless. Coefficient
+    // tables are built for the base rate; the chain designs exactly when
+    // oversampling.
+    auto& os = path.standbyOversampler();
+    auto& chain = path.standbyChain();
+    os.setStages(mode.numStages, mode.phase);
+    const int factor = os.getFactor();
+    chain.prepare(preparedSampleRate * factor,
+                  factor == 1 ? preparedBlockSize : Oversampler<SampleType>::chunkSize * factor,
+                  getTotalNumOutputChannels());
+
+    // Switching to the FIR starts it from silence, like the chain. It only
+    // changes state in a swap, so while it's off the audio thread isn't
+    // running it and it can be cleared here. The oversampling settings don't
+    // apply to it.
+    if (mode.linearPhase && ! linear.isEnabled())
+        linear.reset();
+
+    mode.latency = mode.linearPhase ? linear.getLatencySamples()
+                                    : os.getLatencySamples() + (chain.getLatencySamples() + factor - 1) / factor;
+    path.standbyMode = mode;
+    path.standbyState.store(Ready, std::memory_order_release);
+    return true;
+}
+
+template <typename SampleType>
+void PluginProcessor::updateMode(ModePath<SampleType> &path, LinearPhaseEQ<SampleType> &linear, BypassFade<SampleType> &fade)
+{
+    int expected = Ready;
+    if (! path.standbyState.compare_exchange_strong(expected, Swapping, std::memory_order_acquire))
+        return;
+
+    const auto& mode = path.standbyMode;
+    path.active = 1 - path.active;
+    linear.setEnabled(mode.linearPhase);
+    fade.setLatency(mode.latency);
+    path.standbyState.store(Idle, std::memory_order_release);
+
+    // The new chain was prepared with default settings; it takes the current
+    // ones outright.
+    updateParameters(true);
+}
+
+template <typename SampleType>
+void PluginProcessor::processSamples(juce::AudioBuffer<SampleType> &buffer, ModePath<SampleType> &path,
+                                     LinearPhaseEQ<SampleType> &linear, BypassFade<SampleType> &fade, bool hostBypassed)
+{
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -275,39 +724,106 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Check bypass state
-    const bool bypassed = bypassParam != nullptr && bypassParam->load() > 0.5f;
+    // Mode and oversampling changes are swapped in here, between blocks.
+    updateMode(path, linear, fade);
+    auto& chain = path.chain();
+    auto& os = path.oversampler();
 
-    if (bypassed)
+    // The wet path: the linear-phase FIR, or up, the bands at the high rate,
+    // back down.
+    auto wetPath = [&chain, &os, &linear](SampleType* const* channels, int numChannels, int numSamples)
     {
-        // Bypass: pass audio through unchanged, but reset filter states
-        // to avoid clicks when bypass is turned off
-        for (auto& engine : engines)
+        if (linear.isEnabled())
+            linear.process(channels, numChannels, numSamples);
+        else
+            os.process(channels, numChannels, numSamples,
+                       [&chain](SampleType* const* high, int numHighChannels, int numHighSamples)
+                       { chain.processBlock(high, numHighChannels, numHighSamples); });
+    };
+
+    // Check bypass state; toggling it crossfades wet and dry (BypassFade.h)
+    const bool bypassed = hostBypassed || (bypassParam != nullptr && bypassParam->load() > 0.5f);
+    fade.setBypassed(bypassed);
+    bool& idle = getFiltersIdle<SampleType>();
+
+    if (fade.isBypassed())
+    {
+        // Fully bypassed: the input passes through untouched and the filters
+        // don't run. They're reset once, not on every block; the fade only
+        // keeps the last few ms of input to warm them up again on release.
+        if (! idle)
         {
-            engine.reset();
+            chain.reset();
+            os.reset();
+            if (linear.isEnabled())
+                linear.reset();
+            idle = true;
         }
-        return;
-    }
 
-    // Update parameters from the atomic values (real-time safe)
-    updateParameters();
+        // Events during the bypass still move the settings, for when it's released.
+        const int numSamples = buffer.getNumSamples();
+        applyEventsUntil(parameterEvents, blockStart + numSamples, [this](const ParameterEvent& e) { applyEvent(e); });
+        advanceBlock(numSamples);
 
-    // Process through each engine in series: HighShelf -> MidPeak -> LowShelf
-    for (auto& engine : engines)
-    {
-        engine.processBlock(buffer);
+        fade.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples, wetPath);
+
+        // The analyzer and meters keep showing the (dry) output.
+        updateAnalysis(buffer);
+        return;
     }
 
+    // Take the latest parameter snapshot, if there's a new one (lock-free).
+    // Coming out of bypass the bands start at their settings rather than
+    // gliding there, before the fade runs them over the recorded input.
+    updateParameters(idle);
+    idle = false;
+
+    // Process through the bands in series (by default HighShelf -> MidPeak -> LowShelf).
+    // The fused kernel does this in a single pass over the buffer. Timestamped
+    // changes cut the block where they fall; each piece runs the same way on
+    // a view of the buffer, with the settings as of its first sample.
+    const int numSamples = buffer.getNumSamples();
+    auto& channels = getSubBlockChannels<SampleType>();
+    const int numViewChannels = std::min(buffer.getNumChannels(), static_cast<int>(channels.size()));
+
+    processWithEvents(parameterEvents, blockStart, numSamples, minSubBlock,
+                      [this](const ParameterEvent& e) { applyEvent(e); },
+                      [&](int start, int length)
+                      {
+                          if (settingsChanged)
+                              applySettings(false);
+
+                          if (length == numSamples)
+                          {
+                              fade.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples, wetPath);
+                              return;
+                          }
+
+                          // Raw pointers rather than an AudioBuffer view, which
+                          // allocates its pointer table past 31 channels.
+                          for (int ch = 0; ch < numViewChannels; ++ch)
+                              channels[static_cast<size_t>(ch)] = buffer.getWritePointer(ch, start);
+
+                          fade.process(channels.data(), numViewChannels, length, wetPath);
+                      });
+    advanceBlock(numSamples);
+
+    updateAnalysis(buffer);
+}
+
+template <typename SampleType>
+void PluginProcessor::updateAnalysis(const juce::AudioBuffer<SampleType> &buffer)
+{
     // Push processed audio into FFT FIFOs
     leftChannelFifo.update(buffer);
     rightChannelFifo.update(buffer);
 
     // Update level measurements
-    auto numSamples = buffer.getNumSamples();
+    const int numSamples = buffer.getNumSamples();
     if (buffer.getNumChannels() > 0)
-        measurementL.updateIfGreater(buffer.getMagnitude(0, 0, numSamples));
+        measurementL.updateIfGreater(static_cast<float>(buffer.getMagnitude(0, 0, numSamples)));
     if (buffer.getNumChannels() > 1)
-        measurementR.updateIfGreater(buffer.getMagnitude(1, 0, numSamples));
+        measurementR.updateIfGreater(static_cast<float>(buffer.getMagnitude(1, 0, numSamples)));
 }
 
 //==============================================================================
@@ -322,12 +838,24 @@ juce::AudioProcessorEditor *PluginProcessor::createEditor()
 }
 
 //==============================================================================
+// The parameters are saved by ID. Bands 1-3 keep the IDs they had before
+// there were more bands, and a parameter missing from the state (bands 4-16,
+// the band count, in a session from then) takes its default, so old
+// sessions come back as they were saved.
 void PluginProcessor::getStateInformation(juce::MemoryBlock &destData)
 {
+    const auto state = vts.copyState();
+    if (const auto xml = state.createXml())
+        copyXmlToBinary(*xml, destData);
 }
 
 void PluginProcessor::setStateInformation(const void *data, int sizeInBytes)
 {
+    // replaceState() moves the parameters, and their listeners publish the
+    // new settings to the audio thread.
+    const auto xml = getXmlFromBinary(data, sizeInBytes);
+    if (xml != nullptr && xml->hasTagName(vts.state.getType()))
+        vts.replaceState(juce::ValueTree::fromXml(*xml));
 }
 
 //==============================================================================
@@ -1,19 +1,26 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "DSP/Engine.h"
+#include "DSP/Cascade.h"
+#include "DSP/BypassFade.h"
+#include "DSP/Oversampler.h"
+#include "DSP/LinearPhase.h"
 #include "SPSC.h"
 #include "Measurement.h"
+#include "Utils/TripleBuffer.h"
+#include "Utils/ParameterEvents.h"
 
 #include <array>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 // we don't need to force everything including this class to recompile if we
 // end up changing or editing params! (because we used std::unique_ptr)
 class Parameters;
 
-class PluginProcessor : public juce::AudioProcessor, juce::AudioProcessorValueTreeState::Listener {
+class PluginProcessor : public juce::AudioProcessor, juce::AudioProcessorValueTreeState::Listener,
+                        private juce::AsyncUpdater {
 public:
     PluginProcessor();
     ~PluginProcessor() override;
@@ -24,6 +31,13 @@ public:
     bool isBusesLayoutSupported(const BusesLayout &layouts) const override;
 
     void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
+    void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+    void processBlockBypassed(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
+    void processBlockBypassed(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    // Lets the host's bypass switch drive our parameter (and its crossfade).
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     juce::AudioProcessorEditor *createEditor() override;
     bool hasEditor() const override;
@@ -46,33 +60,241 @@ public:
 
     juce::AudioProcessorValueTreeState& getTreeState() { return vts; }
 
+    // Instruction set of the biquad kernels picked for this CPU (e.g. "fma3+avx2").
+    juce::String getActiveKernelName() const { return Dispatch::getActiveKernelName(); }
+
+    /**
+     * Sample-accurate automation: set a band, band count, Q mode or design
+     * parameter `sampleOffset` samples into the next processBlock() call (or
+     * a later one, if the offset runs past it). The block is split there, so
+     * the new target takes effect on that sample rather than at the next
+     * block. For hosts and renderers that know where their automation
+     * points fall; one thread at a time, points in time order. Doesn't move
+     * the parameter itself.
+     *
+     * @param value The plain value, as getRawParameterValue() would return it
+     * @return false if the parameter can't be automated this way or the queue is full
+     */
+    bool queueParameterChange(const juce::String& paramID, int sampleOffset, float value);
+
 private:
 
     juce::AudioProcessorValueTreeState vts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     void parameterChanged (const juce::String& paramID, float newValue) override;
-    void updateParameters();
+    void publishParameters();
+    void updateParameters(bool immediate = false);
+    void applySettings(bool immediate);
+    void applyEvent(const ParameterEvent& event);
+
+    // Oversampling and EQ mode (osChoice, osPhase, eqMode), and the latency
+    // they add.
+    struct ProcessingMode
+    {
+        int numStages = 0;
+        OversamplingPhase phase = OversamplingPhase::Linear;
+        bool linearPhase = false;
+        int latency = 0;
+
+        bool isSameSetting(const ProcessingMode& other) const
+        {
+            return numStages == other.numStages && phase == other.phase && linearPhase == other.linearPhase;
+        }
+    };
+
+    // One precision's IIR path, twice over: the running chain and
+    // oversampler, and a standby pair the message thread prepares for the
+    // next mode. The audio thread swaps them between blocks; neither thread
+    // touches the other's pair. standbyState hands the standby over: the
+    // message thread holds it Preparing while it works, leaves it Ready for
+    // standbyMode, and the audio thread holds it Swapping while it takes it.
+    enum StandbyState { Idle, Preparing, Ready, Swapping };
+
+    template <typename SampleType>
+    struct ModePath
+    {
+        std::array<Cascade<SampleType>, 2> chains;
+        std::array<Oversampler<SampleType>, 2> oversamplers;
+        int active = 0;
+        ProcessingMode standbyMode;
+        std::atomic<int> standbyState { Idle };
+
+        Cascade<SampleType>& chain() { return chains[static_cast<size_t>(active)]; }
+        Oversampler<SampleType>& oversampler() { return oversamplers[static_cast<size_t>(active)]; }
+        Cascade<SampleType>& standbyChain() { return chains[static_cast<size_t>(1 - active)]; }
+        Oversampler<SampleType>& standbyOversampler() { return oversamplers[static_cast<size_t>(1 - active)]; }
+    };
+
+    // Mode changes: parameterChanged() triggers handleAsyncUpdate(), which
+    // prepares the standby pairs and reports the latency on the message
+    // thread; updateMode() swaps them in on the audio thread.
+    void handleAsyncUpdate() override;
+    ProcessingMode readMode() const;
+
+    template <typename SampleType>
+    bool prepareMode(ModePath<SampleType>& path, LinearPhaseEQ<SampleType>& linear, ProcessingMode& mode);
+
+    template <typename SampleType>
+    void updateMode(ModePath<SampleType>& path, LinearPhaseEQ<SampleType>& linear, BypassFade<SampleType>& fade);
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, ModePath<SampleType>& path,
+                        LinearPhaseEQ<SampleType>& linear, BypassFade<SampleType>& fade, bool hostBypassed);
+
+    // Feed the analyzer taps and level meters with the block's output.
+    template <typename SampleType>
+    void updateAnalysis(const juce::AudioBuffer<SampleType>& buffer);
 
     // Atomic parameter pointers for real-time safe access
-    std::atomic<float>* highShelfParam = nullptr;
-    std::atomic<float>* highShelfGainParam = nullptr;
-    std::atomic<float>* midPeakParam = nullptr;
-    std::atomic<float>* midPeakGainParam = nullptr;
-    std::atomic<float>* lowShelfParam = nullptr;
-    std::atomic<float>* lowShelfGainParam = nullptr;
+    std::array<std::atomic<float>*, Cascade<float>::maxBands> bandFreqParams {};
+    std::array<std::atomic<float>*, Cascade<float>::maxBands> bandGainParams {};
+    std::array<std::atomic<float>*, Cascade<float>::maxBands> bandTypeParams {};
+    std::atomic<float>* numBandsParam = nullptr;
     std::atomic<float>* qModeParam = nullptr;
+    std::atomic<float>* designMethodParam = nullptr;
     std::atomic<float>* bypassParam = nullptr;
+    std::atomic<float>* osChoiceParam = nullptr;
+    std::atomic<float>* osPhaseParam = nullptr;
+    std::atomic<float>* eqModeParam = nullptr;
+
+    // Everything the bands are set from, read in one go.
+    struct BandSettings
+    {
+        float frequency = 1000.0f;
+        float gainDB = 0.0f;
+        FilterType type = FilterType::Peaking;
+    };
+
+    struct ParameterSnapshot
+    {
+        std::array<BandSettings, Cascade<float>::maxBands> bands {};
+        int numBands = Cascade<float>::defaultNumBands;
+        QMode qMode = QMode::Constant_Q;
+        DesignMethod designMethod = DesignMethod::Bilinear;
+    };
+
+    // Band settings from parameterChanged() (any thread) to the audio thread,
+    // which only touches the chains when a new snapshot has arrived. Threads
+    // publishing at once are coalesced: whoever holds `publishing` publishes
+    // again while `publishPending` is set, so the last change is never lost.
+    TripleBuffer<ParameterSnapshot> parameterSnapshots;
+    std::atomic<bool> publishing { false };
+    std::atomic<bool> publishPending { false };
+
+    // Snapshot fields by index, for ParameterEvent: band b's frequency, gain
+    // and type are 3b, 3b + 1 and 3b + 2, then the band count, Q mode and
+    // design method.
+    static constexpr int numBandFields = 3;
+    static constexpr int numBandsIndex = numBandFields * Cascade<float>::maxBands;
+    static constexpr int qModeIndex = numBandsIndex + 1;
+    static constexpr int designMethodIndex = numBandsIndex + 2;
+    static constexpr int numSnapshotFields = numBandsIndex + 3;
+
+    // Parameter ID to snapshot field, filled once by the constructor: the
+    // numbered bands' IDs are built strings, so matching them one by one
+    // would allocate on every parameter callback.
+    juce::HashMap<juce::String, int> snapshotIndices;
+
+    int getSnapshotIndex(const juce::String& paramID) const;
+    static void setSnapshotField(ParameterSnapshot& snapshot, int index, float value);
+    static float getSnapshotField(const ParameterSnapshot& snapshot, int index);
+
+    // What the audio thread has set the bands to: the snapshots' changes,
+    // merged field by field, so a snapshot carrying some other change doesn't
+    // undo a timestamped one; then the events on top. Audio thread only.
+    ParameterSnapshot settings;
+    ParameterSnapshot lastSnapshot;
+    bool settingsChanged = true;
+
+    // Timestamped changes from queueParameterChange(). Times count samples at
+    // the host rate from prepareToPlay(); nextBlockStart is where the next
+    // block begins, for the producer to stamp its offsets from. Blocks are
+    // cut no closer than minSubBlock samples (processWithEvents()).
+    static constexpr int minSubBlock = 32;
+    ParameterEventQueue<1024> parameterEvents;
+    std::atomic<std::int64_t> nextBlockStart { 0 };
+    std::int64_t blockStart = 0;
+
+    // Channel pointers for sub-blocks of the host buffer, passed down raw:
+    // an AudioBuffer view allocates its pointer table past 31 channels.
+    std::vector<float*> subBlockChannels;
+    std::vector<double*> subBlockChannelsDouble;
+
+    template <typename SampleType>
+    std::vector<SampleType*>& getSubBlockChannels()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return subBlockChannels;
+        else
+            return subBlockChannelsDouble;
+    }
+
+    void advanceBlock(int numSamples)
+    {
+        blockStart += numSamples;
+        nextBlockStart.store(blockStart);
+    }
+
+    // Bands: the first numBands of the band parameters, by default
+    // 0 = HighShelf, 1 = MidPeak (Peaking), 2 = LowShelf, in the running
+    // chain of each path. Oversampling around each chain (osChoice, osPhase):
+    // the oversamplers are allocated for 16x in prepareToPlay(), so the
+    // factor can change while playing; the standby chain is prepared at the
+    // new rate. One path per processing precision; the host picks which runs.
+    ModePath<float> modePath;
+    ModePath<double> modePathDouble;
+
+    // The chains' filter design (designMethod). A change redesigns the bands
+    // at once rather than waiting for the next parameter move.
+    DesignMethod designMethod = DesignMethod::Bilinear;
+
+    // The mode last handed to the paths, and what the standbys are prepared
+    // with. Message thread and prepareToPlay(), under modeLock.
+    ProcessingMode currentMode;
+    juce::CriticalSection modeLock;
+    double preparedSampleRate = 44100.0;
+    int preparedBlockSize = 0;
+
+    // For getTailLengthSeconds(), set by prepareToPlay().
+    std::atomic<double> tailLengthSeconds { 0.0 };
+
+    // The Linear Phase mode (eqMode): an FIR with the bands' magnitude, run
+    // instead of the oversampled chain. Enabled, the designer redesigns it in
+    // the background whenever the bands change, once for both precisions.
+    // Declared first so it outlives the EQs attached to it.
+    LinearPhaseDesigner linearPhaseDesigner;
+    LinearPhaseEQ<float> linearPhase { linearPhaseDesigner };
+    LinearPhaseEQ<double> linearPhaseDouble { linearPhaseDesigner };
+
+    // Wet/dry crossfade on bypass, one per chain. Once fully bypassed the
+    // running chain is reset once and then left idle until bypass is released.
+    // Each chain keeps its own idle flag: the host can switch precision while
+    // bypassed, and the other chain still has to be reset before it resumes.
+    BypassFade<float> bypassFade;
+    BypassFade<double> bypassFadeDouble;
+    bool filtersIdle = false;
+    bool filtersIdleDouble = false;
+
+    template <typename SampleType>
+    bool& getFiltersIdle()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return filtersIdle;
+        else
+            return filtersIdleDouble;
+    }
 
-    // Engines: 0 = HighShelf, 1 = MidPeak (Peaking), 2 = LowShelf
-    static constexpr int NUM_ENGINES = 3;
-    std::array<Engine, NUM_ENGINES> engines;
+    // Precomputed designs for both chains, shared with other instances
+    // (only with the BIQUAD3_COEFF_TABLE build option).
+    std::shared_ptr<const CoeffTable> coeffTable;
 
     // Default Q value for filters
     static constexpr float defaultQ = 0.707f;
 
 public:
     using BlockType = juce::AudioBuffer<float>;
+    static constexpr int analyzerBlockSize = 512;
     SingleChannelSampleFifo<BlockType> leftChannelFifo  { Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo { Channel::Right };
 
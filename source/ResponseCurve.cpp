@@ -2,45 +2,34 @@
 #include "PluginProcessor.h"
 #include "DSP/Qcalc.h"
 #include "Utils/Parameters.h"
+#include <array>
 #include <cmath>
 #include <limits>
 
 //==============================================================================
 FFTSpectrumComponent::FFTSpectrumComponent(PluginProcessor& p) :
 processorRef(p),
-leftPathProducer(processorRef.leftChannelFifo),
-rightPathProducer(processorRef.rightChannelFifo)
+pathProducer(processorRef.leftChannelFifo, processorRef.rightChannelFifo),
+analyzer(AnalyzerService::getShared())
 {
     auto& apvts = processorRef.getTreeState();
 
-    // Initialize cached
-    hsFreqHz.store(apvts.getRawParameterValue(highShelfID.getParamID())->load());
-    hsGainDb.store(apvts.getRawParameterValue(highShelfGainID.getParamID())->load());
-    mpFreqHz.store(apvts.getRawParameterValue(midPeakID.getParamID())->load());
-    mpGainDb.store(apvts.getRawParameterValue(midPeakGainID.getParamID())->load());
-    lsFreqHz.store(apvts.getRawParameterValue(lowShelfID.getParamID())->load());
-    lsGainDb.store(apvts.getRawParameterValue(lowShelfGainID.getParamID())->load());
-
-    // Listen
-    apvts.addParameterListener(highShelfID.getParamID(), this);
-    apvts.addParameterListener(highShelfGainID.getParamID(), this);
-    apvts.addParameterListener(midPeakID.getParamID(), this);
-    apvts.addParameterListener(midPeakGainID.getParamID(), this);
-    apvts.addParameterListener(lowShelfID.getParamID(), this);
-    apvts.addParameterListener(lowShelfGainID.getParamID(), this);
+    for (int b = 0; b < maxEqBands; ++b)
+    {
+        const auto band = static_cast<size_t>(b);
+        bandFreqParams[band] = apvts.getRawParameterValue(bandFreqID(b).getParamID());
+        bandGainParams[band] = apvts.getRawParameterValue(bandGainID(b).getParamID());
+    }
+    numBandsParam = apvts.getRawParameterValue(numBandsID.getParamID());
+
+    analyzer->addClient(pathProducer);
 
     startTimerHz(60);
 }
 
 FFTSpectrumComponent::~FFTSpectrumComponent()
 {
-    auto& apvts = processorRef.getTreeState();
-    apvts.removeParameterListener(highShelfID.getParamID(), this);
-    apvts.removeParameterListener(highShelfGainID.getParamID(), this);
-    apvts.removeParameterListener(midPeakID.getParamID(), this);
-    apvts.removeParameterListener(midPeakGainID.getParamID(), this);
-    apvts.removeParameterListener(lowShelfID.getParamID(), this);
-    apvts.removeParameterListener(lowShelfGainID.getParamID(), this);
+    analyzer->removeClient(pathProducer);
 }
 
 void FFTSpectrumComponent::paint(juce::Graphics& g)
@@ -52,17 +41,15 @@ void FFTSpectrumComponent::paint(juce::Graphics& g)
 
     auto responseArea = getAnalysisArea();
 
-    auto leftChannelFFTPath = leftPathProducer.getPath();
-    leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+    // The analyzer paths are drawn where they are, moved by the stroke's
+    // transform rather than copied and moved.
+    const auto toResponseArea = AffineTransform::translation(responseArea.getX(), responseArea.getY());
 
     g.setColour(Colour(97u, 18u, 167u));
-    g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
-
-    auto rightChannelFFTPath = rightPathProducer.getPath();
-    rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+    g.strokePath(pathProducer.getPath(0), PathStrokeType(1.f), toResponseArea);
 
     g.setColour(Colour(215u, 201u, 134u));
-    g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+    g.strokePath(pathProducer.getPath(1), PathStrokeType(1.f), toResponseArea);
 
     // Draw the response curve
     drawResponseCurve(g);
@@ -84,27 +71,10 @@ void FFTSpectrumComponent::paint(juce::Graphics& g)
     g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 }
 
-void FFTSpectrumComponent::parameterChanged(const juce::String& parameterID, float newValue)
-{
-    // Called from the audio thread by APVTS. Only update atomics here.
-    if (parameterID == highShelfID.getParamID())
-        hsFreqHz.store(newValue);
-    else if (parameterID == highShelfGainID.getParamID())
-        hsGainDb.store(newValue);
-    else if (parameterID == midPeakID.getParamID())
-        mpFreqHz.store(newValue);
-    else if (parameterID == midPeakGainID.getParamID())
-        mpGainDb.store(newValue);
-    else if (parameterID == lowShelfID.getParamID())
-        lsFreqHz.store(newValue);
-    else if (parameterID == lowShelfGainID.getParamID())
-        lsGainDb.store(newValue);
-}
-
 void FFTSpectrumComponent::mouseMove(const juce::MouseEvent& e)
 {
     const auto h = getHandleAtPosition(e.position);
-    const bool hovering = (h != DragHandle::none);
+    const bool hovering = (h != noHandle);
 
     if (hoverAnyHandle.exchange(hovering) != hovering)
         setMouseCursor(hovering ? juce::MouseCursor::PointingHandCursor : juce::MouseCursor::NormalCursor);
@@ -112,11 +82,17 @@ void FFTSpectrumComponent::mouseMove(const juce::MouseEvent& e)
 
 void FFTSpectrumComponent::mouseDown(const juce::MouseEvent& e)
 {
+    if (e.mods.isPopupMenu())
+    {
+        showAnalyzerMenu();
+        return;
+    }
+
     if (! e.mods.isLeftButtonDown())
         return;
 
     const auto h = getHandleAtPosition(e.position);
-    if (h == DragHandle::none)
+    if (h == noHandle)
         return;
 
     activeHandle = h;
@@ -127,7 +103,7 @@ void FFTSpectrumComponent::mouseDown(const juce::MouseEvent& e)
 
 void FFTSpectrumComponent::mouseDrag(const juce::MouseEvent& e)
 {
-    if (activeHandle == DragHandle::none)
+    if (activeHandle == noHandle)
         return;
 
     setHandleFromPosition(activeHandle, e.position);
@@ -135,19 +111,38 @@ void FFTSpectrumComponent::mouseDrag(const juce::MouseEvent& e)
 
 void FFTSpectrumComponent::mouseUp(const juce::MouseEvent& e)
 {
-    if (activeHandle == DragHandle::none)
+    if (activeHandle == noHandle)
         return;
 
     endGestureForHandle(activeHandle);
-    activeHandle = DragHandle::none;
+    activeHandle = noHandle;
 
     // Refresh hover state and cursor
     const auto h = getHandleAtPosition(e.position);
-    const bool hovering = (h != DragHandle::none);
+    const bool hovering = (h != noHandle);
     hoverAnyHandle.store(hovering);
     setMouseCursor(hovering ? juce::MouseCursor::PointingHandCursor : juce::MouseCursor::NormalCursor);
 }
 
+void FFTSpectrumComponent::showAnalyzerMenu()
+{
+    // More overlap means more FFTs per second, up to one per displayed frame.
+    static constexpr std::array<double, 3> overlaps { 0.0, 0.5, 0.75 };
+    static constexpr std::array<const char*, 3> overlapNames { "None", "50%", "75%" };
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Analyzer Overlap");
+    for (size_t i = 0; i < overlaps.size(); ++i)
+        menu.addItem(static_cast<int>(i) + 1, overlapNames[i], true, pathProducer.getOverlap() == overlaps[i]);
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withMousePosition(),
+                       [safeThis = juce::Component::SafePointer<FFTSpectrumComponent>(this)](int result)
+                       {
+                           if (safeThis != nullptr && result > 0)
+                               safeThis->pathProducer.setOverlap(overlaps[static_cast<size_t>(result - 1)]);
+                       });
+}
+
 void FFTSpectrumComponent::beginGesture(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID)
 {
     if (auto* p = apvts.getParameter(paramID))
@@ -168,79 +163,31 @@ void FFTSpectrumComponent::setParameterValue(juce::AudioProcessorValueTreeState&
         p->setValueNotifyingHost(p->convertTo0to1(newValue));
 }
 
-void FFTSpectrumComponent::beginGestureForHandle(DragHandle h)
+void FFTSpectrumComponent::beginGestureForHandle(int band)
 {
     auto& apvts = processorRef.getTreeState();
-
-    switch (h)
-    {
-        case DragHandle::lowShelf:
-            beginGesture(apvts, lowShelfID.getParamID());
-            beginGesture(apvts, lowShelfGainID.getParamID());
-            break;
-        case DragHandle::midPeak:
-            beginGesture(apvts, midPeakID.getParamID());
-            beginGesture(apvts, midPeakGainID.getParamID());
-            break;
-        case DragHandle::highShelf:
-            beginGesture(apvts, highShelfID.getParamID());
-            beginGesture(apvts, highShelfGainID.getParamID());
-            break;
-        case DragHandle::none:
-            break;
-    }
+    beginGesture(apvts, bandFreqID(band).getParamID());
+    beginGesture(apvts, bandGainID(band).getParamID());
 }
 
-void FFTSpectrumComponent::endGestureForHandle(DragHandle h)
+void FFTSpectrumComponent::endGestureForHandle(int band)
 {
     auto& apvts = processorRef.getTreeState();
+    endGesture(apvts, bandFreqID(band).getParamID());
+    endGesture(apvts, bandGainID(band).getParamID());
+}
 
-    switch (h)
-    {
-        case DragHandle::lowShelf:
-            endGesture(apvts, lowShelfID.getParamID());
-            endGesture(apvts, lowShelfGainID.getParamID());
-            break;
-        case DragHandle::midPeak:
-            endGesture(apvts, midPeakID.getParamID());
-            endGesture(apvts, midPeakGainID.getParamID());
-            break;
-        case DragHandle::highShelf:
-            endGesture(apvts, highShelfID.getParamID());
-            endGesture(apvts, highShelfGainID.getParamID());
-            break;
-        case DragHandle::none:
-            break;
-    }
+int FFTSpectrumComponent::getNumHandles()
+{
+    return juce::jlimit(1, maxEqBands, juce::roundToInt(numBandsParam->load()));
 }
 
-juce::Point<float> FFTSpectrumComponent::getHandlePosition(DragHandle h)
+juce::Point<float> FFTSpectrumComponent::getHandlePosition(int band)
 {
     const auto area = getAnalysisArea().toFloat();
 
-    float freqHz = 1000.0f;
-    float gainDb = 0.0f;
-
-    switch (h)
-    {
-        case DragHandle::lowShelf:
-            freqHz = lsFreqHz.load();
-            gainDb = lsGainDb.load();
-            break;
-        case DragHandle::midPeak:
-            freqHz = mpFreqHz.load();
-            gainDb = mpGainDb.load();
-            break;
-        case DragHandle::highShelf:
-            freqHz = hsFreqHz.load();
-            gainDb = hsGainDb.load();
-            break;
-        case DragHandle::none:
-            break;
-    }
-
-    freqHz = juce::jlimit(20.0f, 20000.0f, freqHz);
-    gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
+    const float freqHz = juce::jlimit(20.0f, 20000.0f, bandFreqParams[static_cast<size_t>(band)]->load());
+    const float gainDb = juce::jlimit(-24.0f, 24.0f, bandGainParams[static_cast<size_t>(band)]->load());
 
     const float x = area.getX() + area.getWidth() * juce::mapFromLog10(freqHz, 20.0f, 20000.0f);
     const float y = juce::jmap(gainDb, -24.0f, 24.0f, area.getBottom(), area.getY());
@@ -248,35 +195,35 @@ juce::Point<float> FFTSpectrumComponent::getHandlePosition(DragHandle h)
     return { x, juce::jlimit(area.getY(), area.getBottom(), y) };
 }
 
-FFTSpectrumComponent::DragHandle FFTSpectrumComponent::getHandleAtPosition(juce::Point<float> pos)
+int FFTSpectrumComponent::getHandleAtPosition(juce::Point<float> pos)
 {
     const auto area = getAnalysisArea().toFloat();
     if (! area.contains(pos))
-        return DragHandle::none;
+        return noHandle;
 
     constexpr float hitRadius = 10.0f;
     constexpr float hitRadiusSq = hitRadius * hitRadius;
 
     struct Candidate
     {
-        DragHandle h { DragHandle::none };
+        int band { noHandle };
         float distSq { std::numeric_limits<float>::max() };
     };
 
     Candidate best;
-    for (auto h : { DragHandle::lowShelf, DragHandle::midPeak, DragHandle::highShelf })
+    for (int band = 0; band < getNumHandles(); ++band)
     {
-        auto p = getHandlePosition(h);
+        auto p = getHandlePosition(band);
         auto d = p - pos;
         const float dsq = d.getX() * d.getX() + d.getY() * d.getY();
         if (dsq < best.distSq)
-            best = { h, dsq };
+            best = { band, dsq };
     }
 
-    return (best.distSq <= hitRadiusSq) ? best.h : DragHandle::none;
+    return (best.distSq <= hitRadiusSq) ? best.band : noHandle;
 }
 
-void FFTSpectrumComponent::setHandleFromPosition(DragHandle h, juce::Point<float> pos)
+void FFTSpectrumComponent::setHandleFromPosition(int band, juce::Point<float> pos)
 {
     auto area = getAnalysisArea().toFloat();
     pos.x = juce::jlimit(area.getX(), area.getRight(), pos.x);
@@ -289,30 +236,8 @@ void FFTSpectrumComponent::setHandleFromPosition(DragHandle h, juce::Point<float
                                       juce::jmap(pos.y, area.getBottom(), area.getY(), -24.0f, 24.0f));
 
     auto& apvts = processorRef.getTreeState();
-
-    switch (h)
-    {
-        case DragHandle::lowShelf:
-            setParameterValue(apvts, lowShelfID.getParamID(), freqHz);
-            setParameterValue(apvts, lowShelfGainID.getParamID(), gainDb);
-            lsFreqHz.store(freqHz);
-            lsGainDb.store(gainDb);
-            break;
-        case DragHandle::midPeak:
-            setParameterValue(apvts, midPeakID.getParamID(), freqHz);
-            setParameterValue(apvts, midPeakGainID.getParamID(), gainDb);
-            mpFreqHz.store(freqHz);
-            mpGainDb.store(gainDb);
-            break;
-        case DragHandle::highShelf:
-            setParameterValue(apvts, highShelfID.getParamID(), freqHz);
-            setParameterValue(apvts, highShelfGainID.getParamID(), gainDb);
-            hsFreqHz.store(freqHz);
-            hsGainDb.store(gainDb);
-            break;
-        case DragHandle::none:
-            break;
-    }
+    setParameterValue(apvts, bandFreqID(band).getParamID(), freqHz);
+    setParameterValue(apvts, bandGainID(band).getParamID(), gainDb);
 
     repaint();
 }
@@ -325,10 +250,13 @@ void FFTSpectrumComponent::drawDragHandles(juce::Graphics& g)
     g.saveState();
     g.reduceClipRegion(area.toNearestInt());
 
-    auto drawOne = [&](DragHandle h, Colour fill, Colour outline)
+    const auto fill = Colours::white.withAlpha(0.9f);
+    const auto outline = Colours::orange.withAlpha(0.9f);
+
+    for (int band = 0; band < getNumHandles(); ++band)
     {
-        const auto p = getHandlePosition(h);
-        const bool active = (activeHandle == h);
+        const auto p = getHandlePosition(band);
+        const bool active = (activeHandle == band);
         const float r = active ? 6.0f : 5.0f;
 
         Rectangle<float> b(p.x - r, p.y - r, 2.0f * r, 2.0f * r);
@@ -336,11 +264,7 @@ void FFTSpectrumComponent::drawDragHandles(juce::Graphics& g)
         g.fillEllipse(b);
         g.setColour(outline);
         g.drawEllipse(b, active ? 2.0f : 1.5f);
-    };
-
-    drawOne(DragHandle::lowShelf, Colours::white.withAlpha(0.9f), Colours::orange.withAlpha(0.9f));
-    drawOne(DragHandle::midPeak, Colours::white.withAlpha(0.9f), Colours::orange.withAlpha(0.9f));
-    drawOne(DragHandle::highShelf, Colours::white.withAlpha(0.9f), Colours::orange.withAlpha(0.9f));
+    }
 
     g.restoreState();
 }
@@ -494,43 +418,38 @@ void FFTSpectrumComponent::drawResponseCurve(juce::Graphics& g)
         sampleRate = 44100.0;
 
     // Read current parameter values
-    const float hsFreq = apvts.getRawParameterValue(highShelfID.getParamID())->load();
-    const float hsGain = apvts.getRawParameterValue(highShelfGainID.getParamID())->load();
-    const float mpFreq = apvts.getRawParameterValue(midPeakID.getParamID())->load();
-    const float mpGain = apvts.getRawParameterValue(midPeakGainID.getParamID())->load();
-    const float lsFreq = apvts.getRawParameterValue(lowShelfID.getParamID())->load();
-    const float lsGain = apvts.getRawParameterValue(lowShelfGainID.getParamID())->load();
+    const int numBands = jlimit(1, maxEqBands, roundToInt(apvts.getRawParameterValue(numBandsID.getParamID())->load()));
     const float qModeVal = apvts.getRawParameterValue(qModeID.getParamID())->load();
+    const bool matched = apvts.getRawParameterValue(designMethodID.getParamID())->load() > 0.5f;
 
     const QMode currentQMode = (qModeVal < 0.5f) ? QMode::Constant_Q : QMode::Proportional_Q;
     const double defaultQ = 0.707;
 
-    // Compute biquad coefficients for each filter
-    auto hsCoeffs = Qcalc::calculate(sampleRate, hsFreq, hsGain, defaultQ, currentQMode, FilterType::HighShelf);
-    auto mpCoeffs = Qcalc::calculate(sampleRate, mpFreq, mpGain, defaultQ, currentQMode, FilterType::Peaking);
-    auto lsCoeffs = Qcalc::calculate(sampleRate, lsFreq, lsGain, defaultQ, currentQMode, FilterType::LowShelf);
-
-    // Helper: compute magnitude squared of biquad at angular frequency w0
-    auto magSquared = [](const BiquadCoeffs& c, double w0) -> double
+    // Compute biquad coefficients for the running bands in one batch
+    std::array<double, maxEqBands> freqs, gains, qs, b0, b1, b2, a1, a2;
+    std::array<FilterType, maxEqBands> types;
+    for (int b = 0; b < numBands; ++b)
     {
-        // H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
-        // at z = e^(jw): z^-1 = e^(-jw), z^-2 = e^(-2jw)
-        double cosw = std::cos(w0);
-        double cos2w = std::cos(2.0 * w0);
-
-        double numSq = c.b0*c.b0 + c.b1*c.b1 + c.b2*c.b2
-                      + 2.0*(c.b0*c.b1 + c.b1*c.b2)*cosw
-                      + 2.0*c.b0*c.b2*cos2w;
-
-        double denSq = 1.0 + c.a1*c.a1 + c.a2*c.a2
-                      + 2.0*(c.a1 + c.a1*c.a2)*cosw
-                      + 2.0*c.a2*cos2w;
+        const auto band = static_cast<size_t>(b);
+        freqs[band] = apvts.getRawParameterValue(bandFreqID(b).getParamID())->load();
+        gains[band] = apvts.getRawParameterValue(bandGainID(b).getParamID())->load();
+        qs[band] = defaultQ;
+        types[band] = static_cast<FilterType>(roundToInt(apvts.getRawParameterValue(bandTypeID(b).getParamID())->load()));
+    }
 
-        if (denSq < 1.0e-20)
-            denSq = 1.0e-20;
+    const auto count = static_cast<size_t>(numBands);
+    Qcalc::calculateBatch<double>(sampleRate, std::span(freqs).first(count), std::span(gains).first(count),
+                                  std::span(qs).first(count), std::span(types).first(count), currentQMode,
+                                  { std::span(b0).first(count), std::span(b1).first(count), std::span(b2).first(count),
+                                    std::span(a1).first(count), std::span(a2).first(count) });
 
-        return numSq / denSq;
-    };
+    std::array<BiquadCoeffs, maxEqBands> coeffs;
+    for (size_t b = 0; b < count; ++b)
+    {
+        // The matched designs have no batch version; a few bands per repaint is cheap
+        coeffs[b] = matched ? Qcalc::calculateMatched(sampleRate, freqs[b], gains[b], qs[b], currentQMode, types[b])
+                            : BiquadCoeffs { b0[b], b1[b], b2[b], a1[b], a2[b] };
+    }
 
     // Build the response curve path
     Path responseCurve;
@@ -551,10 +470,10 @@ void FFTSpectrumComponent::drawResponseCurve(juce::Graphics& g)
         double freq = mapToLog10(normX, minFreq, maxFreq);
         double omega = 2.0 * MathConstants<double>::pi * freq / sampleRate;
 
-        // Combined magnitude of all 3 filters
-        double magSq = magSquared(hsCoeffs, omega)
-                     * magSquared(mpCoeffs, omega)
-                     * magSquared(lsCoeffs, omega);
+        // Combined magnitude of the running bands
+        double magSq = 1.0;
+        for (size_t b = 0; b < count; ++b)
+            magSq *= Qcalc::magnitudeSquared(coeffs[b], omega);
 
         double magDb = Decibels::gainToDecibels(std::sqrt(std::max(magSq, 0.0)), (double)minDb);
 
@@ -582,8 +501,10 @@ void FFTSpectrumComponent::timerCallback()
     auto fftBounds = getAnalysisArea().toFloat();
     auto sampleRate = processorRef.getSampleRate();
 
-    leftPathProducer.process(fftBounds, sampleRate);
-    rightPathProducer.process(fftBounds, sampleRate);
+    // The analyzer renders on the shared worker; here we only tell it the
+    // view and pick up whatever paths it has finished.
+    pathProducer.setView(fftBounds, sampleRate);
+    pathProducer.fetchPaths();
 
     repaint();
 }
@@ -4,70 +4,12 @@
 #define BIQUAD3_SPSC_H
 
 #include <JuceHeader.h>
-#include <array>
-
-template<typename T>
-struct Fifo
-{
-    void prepare(int numChannels, int numSamples)
-    {
-        static_assert( std::is_same_v<T, juce::AudioBuffer<float>>,
-                      "prepare(numChannels, numSamples) should only be used when the Fifo is holding juce::AudioBuffer<float>");
-        for( auto& buffer : buffers)
-        {
-            buffer.setSize(numChannels,
-                           numSamples,
-                           false,   //clear everything?
-                           true,    //including the extra space?
-                           true);   //avoid reallocating if you can?
-            buffer.clear();
-        }
-    }
-
-    void prepare(size_t numElements)
-    {
-        static_assert( std::is_same_v<T, std::vector<float>>,
-                      "prepare(numElements) should only be used when the Fifo is holding std::vector<float>");
-        for( auto& buffer : buffers )
-        {
-            buffer.clear();
-            buffer.resize(numElements, 0);
-        }
-    }
-
-    bool push(const T& t)
-    {
-        auto write = fifo.write(1);
-        if( write.blockSize1 > 0 )
-        {
-            buffers[write.startIndex1] = t;
-            return true;
-        }
-
-        return false;
-    }
-
-    bool pull(T& t)
-    {
-        auto read = fifo.read(1);
-        if( read.blockSize1 > 0 )
-        {
-            t = buffers[read.startIndex1];
-            return true;
-        }
-
-        return false;
-    }
-
-    int getNumAvailableForReading() const
-    {
-        return fifo.getNumReady();
-    }
-private:
-    static constexpr int Capacity = 30;
-    std::array<T, Capacity> buffers;
-    juce::AbstractFifo fifo {Capacity};
-};
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 enum Channel
 {
@@ -75,68 +17,137 @@ enum Channel
     Left //effectively 1
 };
 
+/**
+ * Audio tap for the analyzer: one channel of the processed output, from the
+ * audio thread to the GUI.
+ *
+ * A preallocated power-of-two ring of floats. update() copies the whole block
+ * in (one copy, two where it wraps) and publishes it with a single atomic
+ * store; it never allocates, whatever the block size. The reader takes
+ * prepare()'s chunk size at a time. If the reader falls behind, whatever
+ * doesn't fit is dropped and counted (getNumDroppedSamples()) rather than
+ * overwriting what it hasn't read.
+ */
 template<typename BlockType>
 struct SingleChannelSampleFifo
 {
+    // About 0.7 s at 48 kHz: plenty for a GUI reading at 30-60 Hz.
+    static constexpr int capacity = 1 << 15;
+
     SingleChannelSampleFifo(Channel ch) : channelToUse(ch)
     {
-        prepared.set(false);
+        ring.assign(static_cast<size_t>(capacity), 0.0f);
     }
 
-    void update(const BlockType& buffer)
+    // Also takes the double buffers of 64-bit processing; samples are narrowed
+    // to the FIFO's type as they're copied in.
+    template <typename SampleType>
+    void update(const juce::AudioBuffer<SampleType>& buffer)
     {
-        jassert(prepared.get());
-        jassert(buffer.getNumChannels() > channelToUse );
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
-
-        for( int i = 0; i < buffer.getNumSamples(); ++i )
-        {
-            pushNextSampleIntoFifo(channelPtr[i]);
-        }
+        jassert(prepared.load());
+        jassert(buffer.getNumChannels() > 0);
+
+        // Mono buses feed both analyzer channels from channel 0.
+        auto* channelPtr = buffer.getReadPointer(juce::jmin(static_cast<int>(channelToUse), buffer.getNumChannels() - 1));
+
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        const auto space = static_cast<std::uint32_t>(capacity) - (write - readIndex.load(std::memory_order_acquire));
+        const auto numSamples = static_cast<std::uint32_t>(buffer.getNumSamples());
+        const auto length = std::min(numSamples, space);
+
+        if (length < numSamples)
+            droppedSamples.fetch_add(numSamples - length, std::memory_order_relaxed);
+
+        const auto start = write & mask;
+        const auto first = std::min(length, static_cast<std::uint32_t>(capacity) - start);
+        copyIn(ring.data() + start, channelPtr, first);
+        copyIn(ring.data(), channelPtr + first, length - first);
+
+        writeIndex.store(write + length, std::memory_order_release);
     }
 
+    /**
+     * Set the size of the blocks the reader takes. Doesn't allocate, and
+     * needn't follow the host's block size.
+     */
     void prepare(int bufferSize)
     {
-        prepared.set(false);
-        size.set(bufferSize);
-
-        bufferToFill.setSize(1,             //channel
-                             bufferSize,    //num samples
-                             false,         //keepExistingContent
-                             true,          //clear extra space
-                             true);         //avoid reallocating
-        audioBufferFifo.prepare(1, bufferSize);
-        fifoIndex = 0;
-        prepared.set(true);
+        size.store(juce::jlimit(1, capacity, bufferSize));
+        prepared.store(true);
     }
     //==============================================================================
-    int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
-    bool isPrepared() const { return prepared.get(); }
-    int getSize() const { return size.get(); }
+    // 0 until prepare() has set a block size: readers may poll before the host prepares.
+    int getNumCompleteBuffersAvailable() const
+    {
+        const auto length = size.load();
+        if (length == 0)
+            return 0;
+
+        return static_cast<int>(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_relaxed)) / length;
+    }
+
+    bool isPrepared() const { return prepared.load(); }
+    int getSize() const { return size.load(); }
+
+    // Samples update() had no room for since construction.
+    std::uint64_t getNumDroppedSamples() const { return droppedSamples.load(std::memory_order_relaxed); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
-private:
-    Channel channelToUse;
-    int fifoIndex = 0;
-    Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
-    juce::Atomic<bool> prepared = false;
-    juce::Atomic<int> size = 0;
+    /**
+     * Reader: where update() has written up to, counted in samples since
+     * construction (wrapping at 2^32). Taps fed the same blocks and read in
+     * step are at the same position once both have had a block.
+     */
+    std::uint32_t getWritePosition() const { return writeIndex.load(std::memory_order_acquire); }
+
+    /**
+     * Reader: skip everything written before `position` (a getWritePosition()
+     * value), e.g. the audio that piled up while no reader was attached.
+     */
+    void discardUntil(std::uint32_t position)
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        if (static_cast<std::int32_t>(position - read) > 0)
+            readIndex.store(position, std::memory_order_release);
+    }
 
-    void pushNextSampleIntoFifo(float sample)
+    // Reader: the next getSize() samples, if they're all there. Resizes `buf` if it has to.
+    bool getAudioBuffer(BlockType& buf)
     {
-        if (fifoIndex == bufferToFill.getNumSamples())
-        {
-            auto ok = audioBufferFifo.push(bufferToFill);
+        const auto length = static_cast<std::uint32_t>(size.load());
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        if (length == 0 || writeIndex.load(std::memory_order_acquire) - read < length)
+            return false;
 
-            juce::ignoreUnused(ok);
+        buf.setSize(1, static_cast<int>(length), false, false, true);
+        auto* dest = buf.getWritePointer(0);
 
-            fifoIndex = 0;
-        }
+        const auto start = read & mask;
+        const auto first = std::min(length, static_cast<std::uint32_t>(capacity) - start);
+        std::copy(ring.data() + start, ring.data() + start + first, dest);
+        std::copy(ring.data(), ring.data() + (length - first), dest + first);
 
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
+        readIndex.store(read + length, std::memory_order_release);
+        return true;
     }
+private:
+    static constexpr std::uint32_t mask = capacity - 1;
+
+    template <typename SampleType>
+    static void copyIn(float* dest, const SampleType* source, std::uint32_t length)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            std::memcpy(dest, source, length * sizeof(float));
+        else
+            std::transform(source, source + length, dest, [](SampleType x) { return static_cast<float>(x); });
+    }
+
+    Channel channelToUse;
+    std::vector<float> ring;
+    alignas(64) std::atomic<std::uint32_t> writeIndex { 0 };
+    alignas(64) std::atomic<std::uint32_t> readIndex { 0 };
+    std::atomic<std::uint64_t> droppedSamples { 0 };
+    std::atomic<bool> prepared { false };
+    std::atomic<int> size { 0 };
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#ifndef BIQUAD3_PARAMETEREVENTS_H
+#define BIQUAD3_PARAMETEREVENTS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A parameter change that should happen at a given sample: `time` counts
+ * samples from the start of playback, `parameter` is whatever index the
+ * owner gives its parameters, and `value` is the new plain value.
+ */
+struct ParameterEvent
+{
+    std::int64_t time = 0;
+    int parameter = 0;
+    float value = 0.0f;
+};
+
+/**
+ * Lock-free, allocation-free queue of timestamped parameter changes from one
+ * producer thread to the audio thread. Events must be pushed in time order;
+ * the audio thread looks at the oldest one with peek() and takes it with pop()
+ * once it's due.
+ */
+template <int Capacity>
+class ParameterEventQueue {
+public:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    /** Producer: add an event. @return false if the queue is full (the event is dropped) */
+    bool push(const ParameterEvent& event) noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) == static_cast<std::uint32_t>(Capacity))
+            return false;
+
+        events[write & mask] = event;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: the oldest event, or nullptr if there's none. */
+    const ParameterEvent* peek() const noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire))
+            return nullptr;
+
+        return &events[read & mask];
+    }
+
+    /** Consumer: drop the event peek() returned. */
+    void pop() noexcept
+    {
+        readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::uint32_t mask = Capacity - 1;
+
+    std::array<ParameterEvent, Capacity> events {};
+    alignas(64) std::atomic<std::uint32_t> writeIndex { 0 };
+    alignas(64) std::atomic<std::uint32_t> readIndex { 0 };
+};
+
+/**
+ * Run a block of `numSamples` starting at sample `blockStart` in sub-blocks
+ * cut at the queued events, so each one lands on its sample rather than at
+ * the next block.
+ *
+ * Events due at the start of a sub-block go to apply(event) in order, then
+ * process(start, length) runs the sub-block. Cuts are at least
+ * minSubBlock samples apart: an event closer than that to the previous cut
+ * waits for the next one, so dense automation costs at most one cut per
+ * minSubBlock samples (and lands up to minSubBlock - 1 samples late) instead
+ * of turning into per-sample processing. Late events (before blockStart) are
+ * applied at the start; events past the block stay queued.
+ *
+ * @return the number of sub-blocks processed
+ */
+template <typename Queue, typename Apply, typename Process>
+int processWithEvents(Queue& queue, std::int64_t blockStart, int numSamples, int minSubBlock,
+                      Apply&& apply, Process&& process)
+{
+    int numSubBlocks = 0;
+    for (int start = 0; start < numSamples; ++numSubBlocks)
+    {
+        int end = numSamples;
+        while (const ParameterEvent* event = queue.peek())
+        {
+            const std::int64_t offset = event->time - blockStart;
+            if (offset <= start)
+            {
+                apply(*event);
+                queue.pop();
+                continue;
+            }
+
+            end = static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(offset, start + minSubBlock), numSamples));
+            break;
+        }
+
+        process(start, end - start);
+        start = end;
+    }
+
+    return numSubBlocks;
+}
+
+/**
+ * Apply every event due before the end of a block that isn't processed
+ * (e.g. while bypassed), so the settings are current when it resumes.
+ */
+template <typename Queue, typename Apply>
+void applyEventsUntil(Queue& queue, std::int64_t blockEnd, Apply&& apply)
+{
+    while (const ParameterEvent* event = queue.peek())
+    {
+        if (event->time >= blockEnd)
+            break;
+
+        apply(*event);
+        queue.pop();
+    }
+}
+
+#endif
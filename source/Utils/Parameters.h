@@ -8,16 +8,29 @@
 // ============================================ //
 
 static inline const juce::StringArray osItems = { "Off", "2x", "4x", "8x", "16x" };
+static inline const juce::StringArray osPhaseItems = { "Linear Phase", "Minimum Phase" };
+static inline const juce::StringArray eqModeItems = { "Minimum Phase", "Linear Phase" };
 static inline const juce::StringArray qModeItems = { "Constant Q", "Proportional Q" };
+static inline const juce::StringArray designMethodItems = { "Bilinear", "Matched" };
+static inline const juce::StringArray filterTypeItems = { "Peaking", "Low Shelf", "High Shelf" }; // FilterType order
 
 // ============================================ //
 
 static const juce::ParameterID osChoiceID = { "osChoice", 1};
 static constexpr auto osChoiceName = "Oversampling";
 
+static const juce::ParameterID osPhaseID = { "osPhaseID", 1 };
+static constexpr auto osPhaseName = "Oversampling Filter";
+
+static const juce::ParameterID eqModeID = { "eqModeID", 1 };
+static constexpr auto eqModeName = "EQ Mode";
+
 static const juce::ParameterID qModeID = { "qModeID", 1 };
 static constexpr auto qModeName = "Q Mode";
 
+static const juce::ParameterID designMethodID = { "designMethodID", 1 };
+static constexpr auto designMethodName = "Filter Design";
+
 static const juce::ParameterID highShelfID = { "highShelfID", 1 };
 static constexpr auto highShelfName = "High Shelf Freq";
 
@@ -41,6 +54,61 @@ static constexpr auto bypassName = "Bypass";
 
 // ============================================ //
 
+// Bands: up to maxEqBands, the first numBands of them running. Bands 1-3
+// keep the original High Shelf / Mid Peak / Low Shelf parameters; the rest
+// are numbered. Every band's filter type can be changed.
+
+static constexpr int maxEqBands = 16;
+static constexpr int defaultNumBands = 3;
+
+static const juce::ParameterID numBandsID = { "numBandsID", 1 };
+static constexpr auto numBandsName = "Bands";
+
+inline juce::ParameterID bandFreqID(int band)
+{
+    switch (band)
+    {
+        case 0: return highShelfID;
+        case 1: return midPeakID;
+        case 2: return lowShelfID;
+        default: return { "band" + juce::String(band + 1) + "FreqID", 1 };
+    }
+}
+
+inline juce::ParameterID bandGainID(int band)
+{
+    switch (band)
+    {
+        case 0: return highShelfGainID;
+        case 1: return midPeakGainID;
+        case 2: return lowShelfGainID;
+        default: return { "band" + juce::String(band + 1) + "GainID", 1 };
+    }
+}
+
+inline juce::ParameterID bandTypeID(int band)
+{
+    return { "band" + juce::String(band + 1) + "TypeID", 1 };
+}
+
+inline juce::String bandFreqName(int band) { return "Band " + juce::String(band + 1) + " Freq"; }
+inline juce::String bandGainName(int band) { return "Band " + juce::String(band + 1) + " Gain"; }
+inline juce::String bandTypeName(int band) { return "Band " + juce::String(band + 1) + " Type"; }
+
+// Index into filterTypeItems: bands 1-3 as before, the rest peaking.
+inline int defaultBandType(int band)
+{
+    return band == 0 ? 2 : band == 2 ? 1 : 0;
+}
+
+// Numbered bands start spread over the range, one every 1/16 of it on a log scale.
+inline float defaultBandFrequency(int band)
+{
+    return 20.0f * std::pow(1000.0f, (static_cast<float>(band) + 0.5f) / static_cast<float>(maxEqBands));
+}
+
+// ============================================ //
+
 class Parameters {
 public:
     explicit Parameters() {
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef BIQUAD3_TRIPLEBUFFER_H
+#define BIQUAD3_TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+
+/**
+ * Lock-free handoff of a value from one writer thread to one reader thread.
+ *
+ * Three copies: the writer fills its own (getWriteBuffer()) and publish()
+ * swaps it with the shared middle one, marking that as new; the reader's
+ * pull() swaps its own with the middle one if it's new. Neither side ever
+ * waits or sees a half-written value, the reader always gets the latest
+ * complete one, and a pull() with nothing new is one atomic load.
+ *
+ * One writer at a time: several threads may write if something else
+ * orders them (see PluginProcessor::publishParameters()).
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    /** Writer: the copy to fill before publish(). Holds what was there two publishes ago. */
+    T& getWriteBuffer() noexcept { return buffers[static_cast<size_t>(back)]; }
+
+    /** Writer: hand the write buffer over to the reader. */
+    void publish() noexcept
+    {
+        back = middle.exchange(back | newBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /**
+     * Reader: take the latest published value, if there's one since the last pull().
+     * @return true if read() changed
+     */
+    bool pull() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newBit) == 0)
+            return false;
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    /** Reader: the value taken by the last pull() (default-constructed before the first). */
+    const T& read() const noexcept { return buffers[static_cast<size_t>(front)]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newBit = 4;
+
+    std::array<T, 3> buffers {};
+
+    // Each side's index on its own cache line, away from the shared one.
+    alignas(64) int back = 0;
+    alignas(64) std::atomic<int> middle { 1 };
+    alignas(64) int front = 2;
+};
+
+#endif